@@ -0,0 +1,273 @@
+#include "Dynpair.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+using namespace std;
+
+Dynpair::Dynpair(int window)
+{
+    this->window=window>0?window:0;
+    if(this->window>0)
+    {
+        xs.resize(this->window);
+        ys.resize(this->window);
+    }
+    count=first=added=0;
+    pa=pb=-1;
+    best=1e300;
+    g=0;
+}
+
+double Dynpair::dis2(long long s,long long t)
+{
+    return (ys[slot(s)]-ys[slot(t)])*(ys[slot(s)]-ys[slot(t)])+(xs[slot(s)]-xs[slot(t)])*(xs[slot(s)]-xs[slot(t)]);
+}
+
+pair<long long,long long> Dynpair::cellof(long long s)
+{
+    double cx=floor(xs[slot(s)]/g),cy=floor(ys[slot(s)]/g);
+    cx=max(-4e18,min(4e18,cx));                         //超出范围时饱和，仍保持单调
+    cy=max(-4e18,min(4e18,cy));
+    return make_pair((long long)cx,(long long)cy);
+}
+
+//坐标的位模式，重合点得到同一个键（加0.0使-0与0相同）
+pair<long long,long long> Dynpair::siteof(long long s)
+{
+    double x=xs[slot(s)]+0.0,y=ys[slot(s)]+0.0;
+    long long a,b;
+    memcpy(&a,&x,sizeof(a));
+    memcpy(&b,&y,sizeof(b));
+    return make_pair(a,b);
+}
+
+//周围3x3格中序号小于s的点里离s最近者，返回其序号（没有时为-1），d为距离平方；格内序号递增
+long long Dynpair::nearest(long long s,double &d)
+{
+    int i,j;
+    size_t k;
+    long long arg=-1;
+    d=1e300;
+    if(g==0) return -1;
+    pair<long long,long long> c=cellof(s);
+    for(i=-1;i<=1;i++)
+        for(j=-1;j<=1;j++)
+        {
+            auto it=grid.find(make_pair(c.first+i,c.second+j));
+            if(it==grid.end()) continue;
+            for(k=0;k<it->second.size()&&it->second[k]<s;k++)
+            {
+                double e=dis2(s,it->second[k]);
+                if(e<d)
+                {
+                    d=e;
+                    arg=it->second[k];
+                }
+            }
+        }
+    return arg;
+}
+
+//以当前g重新划分已加入结构的全部点；滑动窗口时每个坐标只放最近插入的一个点
+void Dynpair::regrid()
+{
+    long long s;
+    grid.clear();
+    for(s=first;s<added;s++)
+    {
+        if(window>0)
+        {
+            auto it=site.find(siteof(s));
+            if(it==site.end()||it->second!=s) continue;
+        }
+        grid[cellof(s)].push_back(s);
+    }
+}
+
+//把序号为s的点加入结构：与周围3x3格比较，必要时缩小网格
+//最近距离已为0时不可能再缩小，新点不再入网格，否则重合点堆在同一格中使每次插入退化为O(n)
+void Dynpair::add(long long s)
+{
+    double d;
+    if(best==0) return;
+    added=s+1;
+    if(pa<0)                                            //结构中尚无点对
+    {
+        if(s>first)
+        {
+            pa=s-1;
+            pb=s;
+            best=dis2(s,s-1);
+            g=best>0?sqrt(best)*(1+1e-9):1;             //边长略大于d，抵消浮点舍入；重合点时任取
+            regrid();
+        }
+        return;
+    }
+    long long t=nearest(s,d);
+    if(t>=0&&d<best)
+    {
+        best=d;
+        pa=t;
+        pb=s;
+    }
+    grid[cellof(s)].push_back(s);
+    if(best>0&&best*4<g*g)                              //最近距离不足边长一半时以新距离重建网格
+    {
+        g=sqrt(best)*(1+1e-9);
+        regrid();
+    }
+}
+
+//候选点对入堆；堆长到窗口的两倍时删去点本身已移出窗口的项，每个窗口内的点至多留一项
+void Dynpair::push(double d,long long q,long long t)
+{
+    Cand c={d,q,t};
+    heap.push_back(c);
+    push_heap(heap.begin(),heap.end(),Candgreater());
+    if(heap.size()>(size_t)window*2+16)
+    {
+        size_t i,m=0;
+        for(i=0;i<heap.size();i++)
+            if(heap[i].q>=first) heap[m++]=heap[i];
+        heap.resize(m);
+        make_heap(heap.begin(),heap.end(),Candgreater());
+    }
+}
+
+//滑动窗口加入点s：有更早的重合点时二者构成距离0的候选，s在网格中顶替它（被顶替的点存活期间，
+//距离0已是最小，不会漏掉更近的点对）；否则在3x3格中找更早的最近点，距离不足边长1/4时缩小网格
+void Dynpair::slide(long long s)
+{
+    double d;
+    added=s+1;
+    pair<long long,long long> k=siteof(s);
+    auto it=site.find(k);
+    if(it!=site.end())
+    {
+        long long t=it->second;
+        if(g>0)
+        {
+            vector<long long> &v=grid[cellof(t)];
+            v.erase(find(v.begin(),v.end(),t));
+            v.push_back(s);
+        }
+        it->second=s;
+        push(0,s,t);
+        return;
+    }
+    site[k]=s;
+    if(g==0)                                            //出现第一对不重合的点时建立网格
+    {
+        if(s==first) return;
+        g=2*sqrt(dis2(s,s-1));
+        regrid();
+    }
+    else
+        grid[cellof(s)].push_back(s);
+    long long t=nearest(s,d);
+    if(t<0) return;
+    push(d,s,t);
+    if(d*16<g*g)                                        //已有候选在更大的边长下求得，缩小后仍准确
+    {
+        g=2*sqrt(d);
+        regrid();
+    }
+}
+
+//移出窗口内最早的点，它是所在格中序号最小者
+void Dynpair::evict()
+{
+    auto it=site.find(siteof(first));
+    if(it!=site.end()&&it->second==first)
+    {
+        site.erase(it);
+        if(g>0)
+        {
+            auto c=grid.find(cellof(first));
+            c->second.erase(c->second.begin());
+            if(c->second.empty()) grid.erase(c);
+        }
+    }
+    first++;
+}
+
+//网格边长不足最近距离时，以新边长对窗口内的点从头重新维护
+void Dynpair::rebuild()
+{
+    long long s;
+    grid.clear();
+    site.clear();
+    heap.clear();
+    added=first;
+    for(s=first;s<count;s++)
+        slide(s);
+}
+
+void Dynpair::insert(double x,double y)
+{
+    long long s=count;
+    if(window>0&&count-first==window)                   //窗口已满，移出最早的点
+        evict();
+    if(window>0)
+    {
+        xs[slot(s)]=x;
+        ys[slot(s)]=y;
+    }
+    else
+    {
+        xs.push_back(x);
+        ys.push_back(y);
+    }
+    count++;
+    if(window>0) slide(s);
+    else add(s);
+}
+
+//返回当前最近距离，a/b为点对的插入序号（从0开始）；不足两个点时返回1e20且a=b=-1
+//滑动窗口时先清理堆顶：点已移出的项丢弃，另一端已移出的项重新查找。距离不超过g的点对必在3x3格内，
+//故堆顶不超过g时即为最近点对；否则（或堆空）网格太细，以候选距离的2倍为边长重建
+double Dynpair::closest(long long &a,long long &b)
+{
+    while(window>0)
+    {
+        double d;
+        while(!heap.empty()&&heap[0].t<first)
+        {
+            Cand c=heap[0];
+            pop_heap(heap.begin(),heap.end(),Candgreater());
+            heap.pop_back();
+            if(c.q<first) continue;
+            long long t=nearest(c.q,d);
+            if(t>=0) push(d,c.q,t);
+        }
+        if(!heap.empty()&&heap[0].d*(1+1e-9)<=g*g)      //留出余量抵消浮点舍入
+        {
+            best=heap[0].d;
+            pa=heap[0].t;
+            pb=heap[0].q;
+            break;
+        }
+        pa=pb=-1;
+        if(heap.empty())
+        {
+            if(count-first<2) break;
+            d=dis2(count-1,count-2);
+        }
+        else d=heap[0].d;
+        g=2*sqrt(d);
+        rebuild();
+    }
+    a=pa;
+    b=pb;
+    if(pa<0) return 1e20;
+    return sqrt(best);
+}
+
+void Dynpair::pairpos(double &x1,double &y1,double &x2,double &y2)
+{
+    if(pa<0) return;
+    x1=xs[slot(pa)];
+    y1=ys[slot(pa)];
+    x2=xs[slot(pb)];
+    y2=ys[slot(pb)];
+}
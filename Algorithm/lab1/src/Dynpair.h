@@ -0,0 +1,58 @@
+#ifndef DYNPAIR_H
+#define DYNPAIR_H
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+
+//插入点时动态维护最近点对：网格边长g与当前最近距离d满足d<=g<2d，故每格点数有常数上界，
+//新点只需检查周围3x3个格子；d降到g/2以下时才以新d重建网格，重建次数不超过log2(初始距离/最终距离)
+//window>0时只维护最近插入的window个点（滑动窗口）：每个点记下它与窗口内更早的点中最近者构成的候选点对，
+//窗口内最近点对即候选中最小者；候选的另一端被移出时，该点轮到堆顶才重新查找，不必重建整个窗口
+//窗口内d可能变大，g保持在[d,4d]内：d不足g/4时缩小网格，超过g时才以2d为边长重建窗口，即d约翻倍一次
+class Dynpair
+{
+public:
+    Dynpair(int window);
+    void insert(double x,double y);
+    double closest(long long &a,long long &b);
+    void pairpos(double &x1,double &y1,double &x2,double &y2);
+    long long inserted() {return count;}
+private:
+    struct Cellhash
+    {
+        std::size_t operator()(const std::pair<long long,long long> &c) const
+        {
+            return (std::size_t)((unsigned long long)c.first*0x9E3779B97F4A7C15ULL^(unsigned long long)c.second*0xC2B2AE3D27D4EB4FULL);
+        }
+    };
+    typedef struct
+    {
+        double d;                                       //距离的平方
+        long long q,t;                                  //点q与更早的点t
+    } Cand;
+    struct Candgreater                                  //候选堆按距离从小到大
+    {
+        bool operator()(const Cand &a,const Cand &b) const {return a.d>b.d;}
+    };
+    std::unordered_map<std::pair<long long,long long>,std::vector<long long>,Cellhash> grid;
+    std::unordered_map<std::pair<long long,long long>,long long,Cellhash> site; //滑动窗口：每个坐标最近一次插入的序号
+    std::vector<Cand> heap;                             //滑动窗口：候选点对的小根堆，过期项取到堆顶时才处理
+    std::vector<double> xs,ys;                          //点坐标，按插入序号存放（滑动窗口时循环使用）
+    int window;
+    long long count,first;                              //已插入点数与窗口内最早的点序号
+    long long added;                                    //已加入网格的点序号上界（不含）
+    long long pa,pb;                                    //当前最近点对的插入序号
+    double best,g;                                      //最近距离的平方与网格边长
+    int slot(long long s) {return window>0?(int)(s%window):(int)s;}
+    double dis2(long long s,long long t);
+    std::pair<long long,long long> cellof(long long s);
+    std::pair<long long,long long> siteof(long long s);
+    long long nearest(long long s,double &d);
+    void add(long long s);
+    void slide(long long s);
+    void evict();
+    void push(double d,long long q,long long t);
+    void regrid();
+    void rebuild();
+};
+#endif
@@ -0,0 +1,290 @@
+#include "Pointpair.h"
+#include "Extpair.h"
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <queue>
+#define EXTFANIN 64                                     //一趟归并的最大段数
+
+//外存算法分两步，全部为顺序读写：
+//1、按预算每次读入M个点，按x排序后写成有序段（同一个临时文件中的连续区间）
+//2、多路归并各有序段（段数超过EXTFANIN时先多趟归并），归并输出直接按M个点一组切成竖条（slab）；每条求最近点对，
+//   并把条尾与下一条距离可能小于当前最近距离d的点（x>=最后一点x-d）带入下一条
+//条尾超过M/2个点时说明数据在x方向高度集中（如x全相同），此时不再带入，而是把条尾与其后
+//x<=最后一点x+d的点交换坐标写入条带临时文件，全部竖条处理完后对条带递归求解；
+//条尾各点两两距离不小于d，交换坐标后条带在新x方向上稀疏，因此内存始终不超过预算
+
+static bool readblock(FILE *fx,FILE *fy,Point *buf,long long n)
+{
+    static const int chunk=4096;
+    double tx[chunk],ty[chunk];
+    long long i=0;
+    int k,j;
+    while(i<n)
+    {
+        k=(n-i<chunk)?(int)(n-i):chunk;
+        if(fread(tx,sizeof(double),k,fx)!=(size_t)k||fread(ty,sizeof(double),k,fy)!=(size_t)k)
+            return false;
+        for(j=0;j<k;j++,i++)
+        {
+            buf[i].x=tx[j];
+            buf[i].y=ty[j];
+        }
+    }
+    return true;
+}
+
+static bool lessxy(const Point &a,const Point &b)
+{
+    if(a.x!=b.x) return a.x<b.x;
+    return a.y<b.y;
+}
+
+typedef struct
+{
+    long long off,left;                                 //段在临时文件中的起点（以点计）与尚未读入缓冲区的点数
+    std::vector<Point> buf;
+    size_t pos,len;
+} Run;
+
+typedef struct
+{
+    long long off,n;                                    //条带在条带临时文件中的起点与点数
+    double limit;                                       //x不超过limit的点属于该条带
+} Strip;
+
+struct Runless
+{
+    bool operator()(const std::pair<Point,int> &a,const std::pair<Point,int> &b) const {return lessxy(b.first,a.first);}
+};
+typedef std::priority_queue<std::pair<Point,int>,std::vector<std::pair<Point,int> >,Runless> Runheap;
+
+static bool runfill(FILE *f,Run &r)
+{
+    size_t k=(r.left<(long long)r.buf.size())?(size_t)r.left:r.buf.size();
+    r.pos=0;
+    r.len=0;
+    if(k==0||fseek(f,r.off*(long)sizeof(Point),SEEK_SET)!=0) return false;
+    r.len=fread(&r.buf[0],sizeof(Point),k,f);
+    r.off+=r.len;
+    r.left-=r.len;
+    return r.len>0;
+}
+
+//为runs[a..b)分配bufsize个点的缓冲并读入各段的第一个点
+static void runstart(FILE *f,std::vector<Run> &runs,size_t a,size_t b,long long bufsize,Runheap &heap)
+{
+    for(size_t k=a;k<b;k++)
+    {
+        runs[k].buf.resize(bufsize);
+        if(runfill(f,runs[k]))
+            heap.push(std::make_pair(runs[k].buf[runs[k].pos++],(int)k));
+    }
+}
+
+//取出各段中最小的点，并从该段补充下一个点
+static Point runnext(FILE *f,std::vector<Run> &runs,Runheap &heap)
+{
+    std::pair<Point,int> t=heap.top();
+    heap.pop();
+    Run &r=runs[t.second];
+    if(r.pos<r.len||runfill(f,r))
+        heap.push(std::make_pair(r.buf[r.pos++],t.second));
+    return t.first;
+}
+
+//每EXTFANIN个有序段归并为一段，写入新的临时文件后关闭旧文件；各段缓冲与输出缓冲平分预算
+static FILE *mergepass(FILE *f,std::vector<Run> &runs,long long M)
+{
+    FILE *g=tmpfile();
+    if(g==NULL) return NULL;
+    std::vector<Run> next;
+    std::vector<Point> out;
+    long long off=0,bufsize=M/(EXTFANIN+1)+1;
+    for(size_t a=0;a<runs.size();a+=EXTFANIN)
+    {
+        size_t b=std::min(runs.size(),a+(size_t)EXTFANIN),k;
+        Runheap heap;
+        Run r=Run();
+        r.off=off;
+        runstart(f,runs,a,b,bufsize,heap);
+        while(!heap.empty())
+        {
+            out.push_back(runnext(f,runs,heap));
+            if((long long)out.size()==bufsize||heap.empty())
+            {
+                fwrite(&out[0],sizeof(Point),out.size(),g);
+                r.left+=out.size();
+                out.clear();
+            }
+        }
+        for(k=a;k<b;k++)
+            std::vector<Point>().swap(runs[k].buf);
+        off+=r.left;
+        next.push_back(r);
+    }
+    fclose(f);
+    runs.swap(next);
+    if(fflush(g)!=0||ferror(g))
+    {
+        fclose(g);
+        return NULL;
+    }
+    return g;
+}
+
+static void stripadd(FILE *fx,FILE *fy,Strip &s,double x,double y)
+{
+    fwrite(&y,sizeof(double),1,fx);
+    fwrite(&x,sizeof(double),1,fy);
+    s.n++;
+}
+
+//从fx与fy顺序读入n个点的x与y，在M个点的预算内求最近点对；best为已知的最近距离，
+//只有更近的点对才会更新(x1,y1)-(x2,y2)；depth为条带递归的层数。
+//读点失败返回-1，临时文件无法创建或写入返回-2
+static double extcore(FILE *fx,FILE *fy,long long n,long long M,double best,int depth,
+    double &x1,double &y1,double &x2,double &y2)
+{
+    long long i,k;
+    std::vector<Run> runs;                              //第一步：生成有序段，全部写入同一个临时文件
+    std::vector<Point> block;
+    FILE *f=tmpfile();
+    if(f==NULL) return -2;
+    for(i=0;i<n;i+=k)
+    {
+        k=(n-i<M)?n-i:M;
+        block.resize(k);
+        Run r=Run();
+        if(!readblock(fx,fy,&block[0],k))
+        {
+            fclose(f);
+            return -1;
+        }
+        std::sort(block.begin(),block.end(),lessxy);
+        if(fwrite(&block[0],sizeof(Point),k,f)!=(size_t)k)
+        {
+            fclose(f);
+            return -2;
+        }
+        r.off=i;
+        r.left=k;
+        runs.push_back(r);
+    }
+    std::vector<Point>().swap(block);
+    while(runs.size()>EXTFANIN)                         //段数过多时先多趟归并，缓冲不至于过小
+        if((f=mergepass(f,runs,M))==NULL) return -2;
+
+    Runheap heap;                                       //第二步：归并，各段缓冲平分预算
+    runstart(f,runs,0,runs.size(),M/(runs.size()+1)+1,heap);
+    std::vector<Strip> strips;
+    FILE *sfx=NULL,*sfy=NULL;                           //各条带依次写入同一对临时文件，x与y分开，写入时已交换坐标
+    int cur=-1;                                         //仍在接收后续点的条带，至多一个
+    Pointpair *slab=new Pointpair(M);                   //各竖条共用同一块存储，归并结果直接写入
+    while(!heap.empty()&&best>0)                        //最近距离为0时已不可能更近
+    {
+        while(!heap.empty()&&slab->pointnumber<M)
+        {
+            Point p=runnext(f,runs,heap);
+            if(cur>=0&&p.x>strips[cur].limit) cur=-1;
+            if(cur>=0) stripadd(sfx,sfy,strips[cur],p.x,p.y);
+            slab->Addpoint(p.x,p.y);
+        }
+        int m=slab->pointnumber,a,b;
+        double d=slab->ydevide(0,m-1);                 //条内已按x有序
+        if(d<best)
+        {
+            best=d;
+            slab->getpair(a,b);
+            x1=slab->getx(a);
+            y1=slab->gety(a);
+            x2=slab->getx(b);
+            y2=slab->gety(b);
+        }
+        if(heap.empty()) break;
+        double xl=slab->getx(m-1);
+        for(k=m-1;k>0&&slab->getx(k)>=xl-best;k--);    //保留条尾可能与后续点构成更近点对的点
+        if(slab->getx(k)<xl-best) k++;
+        if((m-k)*2>M&&cur>=0)                           //条带打开后读入的点都已在其中，延长即可
+        {
+            strips[cur].limit=max(strips[cur].limit,xl+best);
+            k=m;
+        }
+        else if((m-k)*2>M&&depth<16)                    //条尾过多：交给条带，不再带入下一条
+        {
+            if(sfx==NULL&&(sfx=tmpfile())!=NULL&&(sfy=tmpfile())==NULL)
+            {
+                fclose(sfx);
+                sfx=NULL;
+            }
+            if(sfx!=NULL)
+            {
+                Strip st;
+                st.off=strips.empty()?0:strips.back().off+strips.back().n;
+                st.n=0;
+                st.limit=xl+best;
+                for(i=k;i<m;i++)
+                    stripadd(sfx,sfy,st,slab->getx(i),slab->gety(i));
+                strips.push_back(st);
+                cur=strips.size()-1;
+                k=m;
+            }
+        }
+        slab->Removepoints(k);                          //条尾移到竖条开头
+        if((m-k)*2>M) M=(m-k)*2;                        //条带层数过深或临时文件失败时才会扩大竖条
+    }
+    delete slab;
+    fclose(f);
+    std::vector<Run>().swap(runs);
+
+    for(k=0;k<(long long)strips.size()&&best>0;k++)     //各条带交换坐标后递归求解，结果再换回
+    {
+        double a1,b1,a2,b2,d;
+        if(strips[k].n<2) continue;
+        if(fseek(sfx,strips[k].off*(long)sizeof(double),SEEK_SET)!=0||fseek(sfy,strips[k].off*(long)sizeof(double),SEEK_SET)!=0)
+            d=-2;
+        else
+            d=extcore(sfx,sfy,strips[k].n,M,best,depth+1,a1,b1,a2,b2);
+        if(d<0)
+        {
+            best=d;
+            break;
+        }
+        if(d<best)
+        {
+            best=d;
+            x1=b1;
+            y1=a1;
+            x2=b2;
+            y2=a2;
+        }
+    }
+    if(sfx) fclose(sfx);
+    if(sfy) fclose(sfy);
+    return best;
+}
+
+double extclosest(const char *file,long long budget,double &x1,double &y1,double &x2,double &y2)
+{
+    char head[8];
+    int64_t n;
+    long long M,size;
+    double best;
+    FILE *fx=fopen(file,"rb"),*fy=fopen(file,"rb");
+    if(fx==NULL||fy==NULL||fread(head,1,8,fx)!=8||memcmp(head,"PPB1",4)!=0||fread(&n,sizeof(n),1,fx)!=1
+        ||fseek(fy,0,SEEK_END)!=0||(size=ftell(fy))<16||n<0||n>(size-16)/16)
+    {
+        if(fx) fclose(fx);
+        if(fy) fclose(fy);
+        return -1;
+    }
+    fseek(fy,16+8*n,SEEK_SET);                          //x与y分两路顺序读
+    M=budget/64;                                        //峰值在竖条求解时：每点归并缓冲16字节、竖条16字节、ydevide缓冲24字节，
+                                                        //另留8字节给释放后未归还系统的内存与文件缓冲
+    if(M<1024) M=1024;
+    if(M>0x3fffffff) M=0x3fffffff;
+    best=extcore(fx,fy,n,M,1e20,0,x1,y1,x2,y2);
+    fclose(fx);
+    fclose(fy);
+    return best;
+}
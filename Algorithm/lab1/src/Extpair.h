@@ -0,0 +1,6 @@
+#ifndef EXTPAIR_H
+#define EXTPAIR_H
+//外存最近点对：对放不进内存的二进制点文件，在budget字节的内存预算内求最近点对
+//文件无法读取或格式错误时返回-1，临时文件无法创建或写入时返回-2
+double extclosest(const char *file,long long budget,double &x1,double &y1,double &x2,double &y2);
+#endif
@@ -0,0 +1,194 @@
+#include "Kdtree.h"
+#define LEAFSIZE 8                                      //区间不超过此规模时直接线性扫描
+
+Kdtree::Kdtree(Pointpair &PP)
+{
+    int i;
+    n=PP.pointnumber;
+    kx=new double[n+1];
+    ky=new double[n+1];
+    kid=new int[n+1];
+    kdim=new char[n+1];
+    for(i=0;i<n;i++)
+    {
+        kx[i]=PP.getx(i);
+        ky[i]=PP.gety(i);
+        kid[i]=i;
+    }
+    build(0,n);
+}
+
+Kdtree::~Kdtree()
+{
+    delete []kx;
+    delete []ky;
+    delete []kid;
+    delete []kdim;
+}
+
+//按跨度较大的维取中位数划分，递归后kx/ky/kid即为平铺的树
+void Kdtree::build(int l,int r)
+{
+    int i,m,dim;
+    double minx,maxx,miny,maxy;
+    if(r-l<=LEAFSIZE) return;
+    minx=maxx=kx[l];
+    miny=maxy=ky[l];
+    for(i=l+1;i<r;i++)
+    {
+        minx=min(minx,kx[i]);
+        maxx=max(maxx,kx[i]);
+        miny=min(miny,ky[i]);
+        maxy=max(maxy,ky[i]);
+    }
+    dim=(maxy-miny>maxx-minx);
+    m=(l+r)/2;
+    const double *key=dim?ky:kx;
+    vector<int> idx(r-l);                               //按编号做nth_element后再整体置换三组数组
+    for(i=l;i<r;i++)
+        idx[i-l]=i;
+    nth_element(idx.begin(),idx.begin()+(m-l),idx.end(),[key](int a,int b){return key[a]<key[b];});
+    vector<double> tx(r-l),ty(r-l);
+    vector<int> tid(r-l);
+    for(i=0;i<r-l;i++)
+    {
+        tx[i]=kx[idx[i]];
+        ty[i]=ky[idx[i]];
+        tid[i]=kid[idx[i]];
+    }
+    copy(tx.begin(),tx.end(),kx+l);
+    copy(ty.begin(),ty.end(),ky+l);
+    copy(tid.begin(),tid.end(),kid+l);
+    kdim[m]=dim;
+    build(l,m);
+    build(m+1,r);
+}
+
+//在[l,r)中找距(x,y)最近的k个点（跳过编号self及编号不大于minid的点），heap为距离平方的大根堆
+//bound为当前剪枝半径平方，heap满k个时收紧为堆顶
+void Kdtree::search(int l,int r,double x,double y,int self,int minid,int k,
+    priority_queue<pair<double,int> > &heap,double &bound)
+{
+    int i,m;
+    double d,diff;
+    if(r-l<=LEAFSIZE)
+    {
+        for(i=l;i<r;i++)
+        {
+            d=(ky[i]-y)*(ky[i]-y)+(kx[i]-x)*(kx[i]-x);
+            if(d<bound&&kid[i]!=self&&kid[i]>minid)
+            {
+                heap.push(make_pair(d,kid[i]));
+                if((int)heap.size()>k) heap.pop();
+                if((int)heap.size()==k) bound=min(bound,heap.top().first);
+            }
+        }
+        return;
+    }
+    m=(l+r)/2;
+    d=(ky[m]-y)*(ky[m]-y)+(kx[m]-x)*(kx[m]-x);
+    if(d<bound&&kid[m]!=self&&kid[m]>minid)
+    {
+        heap.push(make_pair(d,kid[m]));
+        if((int)heap.size()>k) heap.pop();
+        if((int)heap.size()==k) bound=min(bound,heap.top().first);
+    }
+    diff=kdim[m]?y-ky[m]:x-kx[m];
+    if(diff<0)                                          //先搜查询点所在一侧，另一侧只在划分线距离小于bound时搜索
+    {
+        search(l,m,x,y,self,minid,k,heap,bound);
+        if(diff*diff<bound) search(m+1,r,x,y,self,minid,k,heap,bound);
+    }
+    else
+    {
+        search(m+1,r,x,y,self,minid,k,heap,bound);
+        if(diff*diff<bound) search(l,m,x,y,self,minid,k,heap,bound);
+    }
+}
+
+//返回距(x,y)最近点的编号，d为其距离；点集为空时返回-1
+int Kdtree::nearest(double x,double y,double &d)
+{
+    priority_queue<pair<double,int> > heap;
+    double bound=1e300;
+    search(0,n,x,y,-1,-1,1,heap,bound);
+    if(heap.empty()) return -1;
+    d=sqrt(heap.top().first);
+    return heap.top().second;
+}
+
+//求每个点的最近邻（不含自身，重合点距离为0），按树序查询以利用缓存
+void Kdtree::allnearest(int *nn,double *nd)
+{
+    int i;
+    for(i=0;i<n;i++)
+    {
+        priority_queue<pair<double,int> > heap;
+        double bound=1e300;
+        search(0,n,kx[i],ky[i],kid[i],-1,1,heap,bound);
+        nn[kid[i]]=heap.empty()?-1:heap.top().second;
+        nd[kid[i]]=heap.empty()?1e20:sqrt(heap.top().first);
+    }
+}
+
+void Kdtree::rangesearch(int l,int r,double x,double y,double r2,vector<int> &out)
+{
+    int i,m;
+    double diff;
+    if(r-l<=LEAFSIZE)
+    {
+        for(i=l;i<r;i++)
+            if((ky[i]-y)*(ky[i]-y)+(kx[i]-x)*(kx[i]-x)<=r2)
+                out.push_back(kid[i]);
+        return;
+    }
+    m=(l+r)/2;
+    if((ky[m]-y)*(ky[m]-y)+(kx[m]-x)*(kx[m]-x)<=r2)
+        out.push_back(kid[m]);
+    diff=kdim[m]?y-ky[m]:x-kx[m];
+    if(diff<=0||diff*diff<=r2) rangesearch(l,m,x,y,r2,out);
+    if(diff>=0||diff*diff<=r2) rangesearch(m+1,r,x,y,r2,out);
+}
+
+//返回距(x,y)不超过r的点数，编号追加到out
+int Kdtree::radius(double x,double y,double r,vector<int> &out)
+{
+    size_t old=out.size();
+    rangesearch(0,n,x,y,r*r,out);
+    return out.size()-old;
+}
+
+//求最近的k个点对，按距离升序写入out
+//若(a,b)（a<b）在前k对中，则比它近的以a为端点的点对不足k个，所以只需对每个点a
+//在编号大于a的点中找至多k个近邻，并以全局第k小距离作为剪枝半径
+void Kdtree::kclosest(int k,vector<Kdpair> &out)
+{
+    int i;
+    priority_queue<pair<double,pair<int,int> > > best;  //全局前k个点对的大根堆
+    out.clear();
+    if(k<=0) return;
+    for(i=0;i<n;i++)
+    {
+        priority_queue<pair<double,int> > heap;
+        double bound=((int)best.size()==k)?best.top().first:1e300;
+        search(0,n,kx[i],ky[i],kid[i],kid[i],k,heap,bound);
+        while(!heap.empty())
+        {
+            pair<double,int> t=heap.top();
+            heap.pop();
+            if((int)best.size()<k||t.first<best.top().first)
+            {
+                best.push(make_pair(t.first,make_pair(kid[i],t.second)));
+                if((int)best.size()>k) best.pop();
+            }
+        }
+    }
+    out.resize(best.size());
+    for(i=best.size()-1;i>=0;i--)
+    {
+        out[i].a=best.top().second.first;
+        out[i].b=best.top().second.second;
+        out[i].d=sqrt(best.top().first);
+        best.pop();
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef KDTREE_H
+#define KDTREE_H
+#include "Pointpair.h"
+#include <vector>
+#include <queue>
+typedef struct
+{
+    int a,b;                                            //点对在Pointpair中的编号，a<b
+    double d;
+} Kdpair;
+
+//建立在Pointpair点集上的k-d树，一次建树后可反复查询
+//结点不用指针：区间[l,r)的中位位置m即为结点，kx/ky/kid按树序平铺存放，kdim[m]为其划分维
+//点编号为建树时Pointpair中的下标，建树后若对Pointpair排序或增删点需重新建树
+class Kdtree
+{
+public:
+    Kdtree(Pointpair &PP);
+    ~Kdtree();
+    int nearest(double x,double y,double &d);
+    void allnearest(int *nn,double *nd);
+    int radius(double x,double y,double r,vector<int> &out);
+    void kclosest(int k,vector<Kdpair> &out);
+private:
+    double *kx,*ky;
+    int *kid;
+    char *kdim;
+    int n;
+    void build(int l,int r);
+    void search(int l,int r,double x,double y,int self,int minid,int k,
+        priority_queue<pair<double,int> > &heap,double &bound);
+    void rangesearch(int l,int r,double x,double y,double r2,vector<int> &out);
+};
+#endif
@@ -0,0 +1,142 @@
+#include "Pointpair.h"
+#include <stdint.h>
+#include <random>
+
+//随机网格法：随机顺序逐点插入，以当前最近距离d为网格边长，新点只需检查周围3x3个格子
+//最近距离变小时以新d重建网格，第i个点引起重建的概率不超过2/i，期望总时间O(n)
+//点按随机顺序复制到连续的gx/gy中；哈希表每项只存格内首点编号，格坐标从该点取得，表项仅4字节
+typedef struct
+{
+    double *gx,*gy;                                     //随机顺序下的点坐标
+    long long *cx,*cy;                                  //各点当前所在格
+    int *next;                                          //同格链表
+    int *table;                                         //开放定址哈希表，存格内首点编号，-1为空
+    int mask;
+} Grid;
+
+static long long cellof(double v,double inv)
+{
+    double c=floor(v*inv);
+    if(c>4e18) return 4000000000000000000LL;            //超出范围时饱和，仍保持单调因而结果正确
+    if(c<-4e18) return -4000000000000000000LL;
+    return (long long)c;
+}
+
+static int *findcell(Grid &g,long long cx,long long cy)
+{
+    unsigned long long k=(unsigned long long)cx*0x9E3779B97F4A7C15ULL^(unsigned long long)cy*0xC2B2AE3D27D4EB4FULL;
+    int h=(int)(k>>20)&g.mask;
+    while(g.table[h]!=-1)                               //线性探测
+    {
+        if(g.cx[g.table[h]]==cx&&g.cy[g.table[h]]==cy)
+            break;
+        h=(h+1)&g.mask;
+    }
+    return &g.table[h];
+}
+
+static void gridinsert(Grid &g,int i)
+{
+    int *h=findcell(g,g.cx[i],g.cy[i]);
+    g.next[i]=*h;
+    *h=i;
+}
+
+double Pointpair::griddis()
+{
+    int n=pointnumber,i,j,k,q,size=0,pl,pr;
+    double best,inv=0,d,dd;
+    if(n<2) return 1e20;
+    int *perm=new int[n];
+    for(i=0;i<n;i++)
+        perm[i]=i;
+    std::mt19937 gen(2334);
+    std::shuffle(perm,perm+n,gen);
+    Grid g;
+    g.gx=new double[n];
+    g.gy=new double[n];
+    g.cx=new long long[n];
+    g.cy=new long long[n];
+    g.next=new int[n];
+    g.table=NULL;
+    for(i=0;i<n;i++)
+    {
+        g.gx[i]=px[perm[i]];
+        g.gy[i]=py[perm[i]];
+    }
+    best=(g.gy[1]-g.gy[0])*(g.gy[1]-g.gy[0])+(g.gx[1]-g.gx[0])*(g.gx[1]-g.gx[0]);
+    pl=0;
+    pr=1;
+    bool rebuild=true;
+    for(i=2;i<n&&best>0;i++)
+    {
+        if(rebuild||2*i>size)                           //最近距离变小或表过满时重建网格
+        {
+            delete []g.table;
+            for(size=16;size<4*i;size*=2);
+            g.mask=size-1;
+            g.table=new int[size];
+            for(k=0;k<size;k++)
+                g.table[k]=-1;
+            inv=1/(sqrt(best)*(1+1e-9));                //格子边长略大于d，抵消浮点舍入
+            for(k=0;k<i;k++)
+            {
+                g.cx[k]=cellof(g.gx[k],inv);
+                g.cy[k]=cellof(g.gy[k],inv);
+                gridinsert(g,k);
+            }
+            rebuild=false;
+        }
+        g.cx[i]=cellof(g.gx[i],inv);
+        g.cy[i]=cellof(g.gy[i],inv);
+        d=best;
+        for(j=-1;j<=1;j++)                              //检查周围3x3个格子
+            for(k=-1;k<=1;k++)
+                for(q=*findcell(g,g.cx[i]+j,g.cy[i]+k);q!=-1;q=g.next[q])
+                {
+                    dd=(g.gy[i]-g.gy[q])*(g.gy[i]-g.gy[q])+(g.gx[i]-g.gx[q])*(g.gx[i]-g.gx[q]);
+                    if(dd<d)
+                    {
+                        d=dd;
+                        pl=q;
+                        pr=i;
+                    }
+                }
+        if(d<best)
+        {
+            best=d;
+            rebuild=true;
+        }
+        else gridinsert(g,i);
+    }
+    minl=min(perm[pl],perm[pr]);
+    minr=max(perm[pl],perm[pr]);
+    delete []perm;
+    delete []g.gx;
+    delete []g.gy;
+    delete []g.cx;
+    delete []g.cy;
+    delete []g.next;
+    delete []g.table;
+    return sqrt(best);
+}
+
+//按引擎编号选择算法，需要的话先按x排序
+double Pointpair::closest(int engine)
+{
+    switch(engine)
+    {
+        case enginebrute:
+            return mindis();
+        case enginedevide:
+            pointsort(0,pointnumber-1);
+            return ydevide(0,pointnumber-1);
+        case engineparallel:
+            pointsort(0,pointnumber-1);
+            return pydevide(0,pointnumber-1);
+        case enginegrid:
+            return griddis();
+        default:
+            return -1;
+    }
+}
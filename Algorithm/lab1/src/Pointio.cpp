@@ -0,0 +1,147 @@
+#include "Pointpair.h"
+#include <string.h>
+#include <string>
+#include <stdlib.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//二进制点文件格式：8字节文件头"PPB1"+4字节保留，int64点数n，随后为n个x与n个y（double）
+static const char binmagic[4]={'P','P','B','1'};
+static const double pow10tab[23]={1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,
+    1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22};
+
+//手写浮点数解析：尾数不超过2^53且十进制指数不超过22时一次乘除即得正确舍入结果，否则交给strtod
+static const char *parsedouble(const char *s,const char *end,double &v)
+{
+    const char *begin=s;
+    bool neg=false,any=false;
+    uint64_t mant=0;
+    int digits=0,exp10=0,e=0;
+    if(s<end&&(*s=='-'||*s=='+')) neg=(*s++=='-');
+    while(s<end&&*s>='0'&&*s<='9')
+    {
+        if(digits<19) mant=mant*10+(*s-'0');
+        else exp10++;
+        if(mant) digits++;
+        any=true;
+        s++;
+    }
+    if(s<end&&*s=='.')
+    {
+        s++;
+        while(s<end&&*s>='0'&&*s<='9')
+        {
+            if(digits<19)
+            {
+                mant=mant*10+(*s-'0');
+                exp10--;
+            }
+            if(mant) digits++;
+            any=true;
+            s++;
+        }
+    }
+    if(!any) return NULL;
+    if(s<end&&(*s=='e'||*s=='E'))
+    {
+        const char *t=s+1;
+        bool eneg=false;
+        if(t<end&&(*t=='-'||*t=='+')) eneg=(*t++=='-');
+        if(t<end&&*t>='0'&&*t<='9')
+        {
+            while(t<end&&*t>='0'&&*t<='9')
+            {
+                if(e<10000) e=e*10+(*t-'0');
+                t++;
+            }
+            exp10+=eneg?-e:e;
+            s=t;
+        }
+    }
+    if(mant<((uint64_t)1<<53)&&exp10>=-22&&exp10<=22)
+    {
+        v=(double)mant;
+        v=(exp10<0)?v/pow10tab[-exp10]:v*pow10tab[exp10];
+    }
+    else
+    {
+        std::string buf(begin,s);                       //慢速路径：整个数字交给strtod保证精度
+        v=strtod(buf.c_str(),NULL);
+        return s;
+    }
+    if(neg) v=-v;
+    return s;
+}
+
+//读取点文件：以"PPB1"开头时按二进制格式直接从映射内存拷贝，否则按"x,y;x,y;..."文本解析
+bool Pointpair::loadfile(const char *file)
+{
+    struct stat st;
+    int fd=open(file,O_RDONLY);
+    if(fd<0) return false;
+    if(fstat(fd,&st)<0)
+    {
+        close(fd);
+        return false;
+    }
+    if(st.st_size==0)
+    {
+        close(fd);
+        return true;
+    }
+    const char *data=(const char *)mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if(data==MAP_FAILED) return false;
+    madvise((void *)data,st.st_size,MADV_SEQUENTIAL);
+    const char *end=data+st.st_size;
+    bool ok=true;
+    if(st.st_size>=16&&memcmp(data,binmagic,4)==0)
+    {
+        int64_t n;
+        memcpy(&n,data+8,sizeof(n));
+        if(n<0||n>0x7fffffff-pointnumber||(uint64_t)n>(uint64_t)(st.st_size-16)/16) ok=false;
+        else Addpoints((const double *)(data+16),(const double *)(data+16)+n,(int)n);
+    }
+    else
+    {
+        const char *s=data,*t;
+        double v[2];
+        int k=0;
+        while(s<end)
+        {
+            if((*s>='0'&&*s<='9')||*s=='-'||*s=='+'||*s=='.')
+            {
+                if((t=parsedouble(s,end,v[k]))!=NULL)
+                {
+                    s=t;
+                    if(++k==2)                          //每读满两个数构成一个点
+                    {
+                        Addpoint(v[0],v[1]);
+                        k=0;
+                    }
+                    continue;
+                }
+            }
+            s++;                                        //跳过','、';'与空白等分隔符
+        }
+    }
+    munmap((void *)data,st.st_size);
+    return ok;
+}
+
+bool Pointpair::savebinary(const char *file)
+{
+    FILE *out=fopen(file,"wb");
+    if(out==NULL) return false;
+    char head[8]={0};
+    int64_t n=pointnumber;
+    memcpy(head,binmagic,4);
+    bool ok=fwrite(head,1,8,out)==8&&fwrite(&n,sizeof(n),1,out)==1
+        &&fwrite(px,sizeof(double),pointnumber,out)==(size_t)pointnumber
+        &&fwrite(py,sizeof(double),pointnumber,out)==(size_t)pointnumber;
+    if(fclose(out)!=0) ok=false;
+    return ok;
+}
@@ -1,23 +1,166 @@
 #include "Pointpair.h"
+#if defined(__x86_64__)||defined(__i386__)
+#include <immintrin.h>
+#define PP_X86
+#endif
+
 Pointpair::Pointpair(int maxpoint)
 {
-    points=new Point[maxpoint+10];
+    capacity=maxpoint+10;
+    px=new double[capacity];
+    py=new double[capacity];
     pointnumber=0;
+    minl=minr=0;
+    usesimd=true;
+    cutoff=1<<13;
+    dynall=dynwin=NULL;
+}
+
+Pointpair::~Pointpair()
+{
+    delete []px;
+    delete []py;
+    delete dynall;
+    delete dynwin;
+}
+
+//扩充存储至少容纳n个点，已有点保持不变
+void Pointpair::reserve(int n)
+{
+    if(n<=capacity) return;
+    double *nx=new double[n];
+    double *ny=new double[n];
+    std::copy(px,px+pointnumber,nx);
+    std::copy(py,py+pointnumber,ny);
+    delete []px;
+    delete []py;
+    px=nx;
+    py=ny;
+    capacity=n;
 }
 
 void Pointpair::Addpoint(double x,double y)
 {
-    points[pointnumber].x=x;
-    points[pointnumber].y=y;
+    if(pointnumber>=capacity)                           //存储已满时容量倍增
+        reserve(capacity*2);
+    px[pointnumber]=x;
+    py[pointnumber]=y;
     pointnumber++;
+    if(dynall!=NULL) dynall->insert(x,y);
+    if(dynwin!=NULL) dynwin->insert(x,y);
+}
+
+void Pointpair::Addpoints(const double *x,const double *y,int n)
+{
+    if(pointnumber+n>capacity)
+        reserve(max(pointnumber+n,capacity*2));
+    std::copy(x,x+n,px+pointnumber);
+    std::copy(y,y+n,py+pointnumber);
+    pointnumber+=n;
+    for(int i=0;i<n;i++)
+    {
+        if(dynall!=NULL) dynall->insert(x[i],y[i]);
+        if(dynwin!=NULL) dynwin->insert(x[i],y[i]);
+    }
+}
+
+//删去前k个点，其余点按原顺序前移
+void Pointpair::Removepoints(int k)
+{
+    if(k<=0) return;
+    if(k>pointnumber) k=pointnumber;
+    std::copy(px+k,px+pointnumber,px);
+    std::copy(py+k,py+pointnumber,py);
+    pointnumber-=k;
+}
+
+//此后每次Addpoint都更新最近点对：window>0时由dynwin维护最近window个点，否则由dynall维护之后插入的全部点
+void Pointpair::trackpairs(int window)
+{
+    delete dynall;
+    delete dynwin;
+    dynall=(window>0)?NULL:new Dynpair(0);
+    dynwin=(window>0)?new Dynpair(window):NULL;
 }
 
 double Pointpair::dis(int p1,int p2)
 {
-    return sqrt((points[p2].y-points[p1].y)*(points[p2].y-points[p1].y)+(points[p2].x-points[p1].x)*(points[p2].x-points[p1].x));
+    return sqrt(dis2(p1,p2));
+}
+
+double Pointpair::dis2(int p1,int p2)
+{
+    return (py[p2]-py[p1])*(py[p2]-py[p1])+(px[p2]-px[p1])*(px[p2]-px[p1]);
+}
+
+//标量距离核：返回点(x,y)到bx/by中n个候选点的最小距离平方，arg为其下标
+static double sqminscalar(double x,double y,const double *bx,const double *by,int n,double best,int &arg)
+{
+    double d;
+    for(int i=0;i<n;i++)
+    {
+        d=(by[i]-y)*(by[i]-y)+(bx[i]-x)*(bx[i]-x);
+        if(d<best)
+        {
+            best=d;
+            arg=i;
+        }
+    }
+    return best;
 }
 
-bool cmpxy(const Point& p1,Point& p2)
+#ifdef PP_X86
+//AVX2距离核：每次比较4个候选点，只有出现更小值时才回到标量逐个确认，保证与标量核结果一致
+__attribute__((target("avx2")))
+static double sqminavx2(double x,double y,const double *bx,const double *by,int n,double best,int &arg)
+{
+    int i,k,m;
+    double d[4];
+    __m256d vx=_mm256_set1_pd(x),vy=_mm256_set1_pd(y),vb=_mm256_set1_pd(best);
+    for(i=0;i+4<=n;i+=4)
+    {
+        __m256d dx=_mm256_sub_pd(_mm256_loadu_pd(bx+i),vx);
+        __m256d dy=_mm256_sub_pd(_mm256_loadu_pd(by+i),vy);
+        __m256d dd=_mm256_add_pd(_mm256_mul_pd(dy,dy),_mm256_mul_pd(dx,dx));
+        m=_mm256_movemask_pd(_mm256_cmp_pd(dd,vb,_CMP_LT_OQ));
+        if(m)
+        {
+            _mm256_storeu_pd(d,dd);
+            for(k=0;k<4;k++)
+                if(d[k]<best)
+                {
+                    best=d[k];
+                    arg=i+k;
+                }
+            vb=_mm256_set1_pd(best);
+        }
+    }
+    for(;i<n;i++)
+    {
+        d[0]=(by[i]-y)*(by[i]-y)+(bx[i]-x)*(bx[i]-x);
+        if(d[0]<best)
+        {
+            best=d[0];
+            arg=i;
+        }
+    }
+    return best;
+}
+#endif
+
+//比较一个点与一块连续候选点的最小距离平方，arg为块内下标（未找到更小值时为-1）
+double Pointpair::sqmin(double x,double y,const double *bx,const double *by,int n,int &arg)
+{
+    arg=-1;
+#ifdef PP_X86
+    static const bool hasavx2=__builtin_cpu_supports("avx2");
+    if(usesimd&&hasavx2&&n>=4)
+        return sqminavx2(x,y,bx,by,n,1e300,arg);
+#endif
+    return sqminscalar(x,y,bx,by,n,1e300,arg);
+}
+
+bool cmpxy(const Point& p1,const Point& p2)
 {
     if(p1.x!=p2.x)
         return p1.x<p2.x;
@@ -26,13 +169,27 @@ bool cmpxy(const Point& p1,Point& p2)
 
 void Pointpair::pointsort(int left,int right)
 {
-    std::sort(points,points+pointnumber-1,cmpxy);
+    int i;
+    if(left>=right) return;
+    Point *temp=new Point[right-left+1];                 //借助临时结构数组排序后再分散回x[]与y[]
+    for(i=left;i<=right;i++)
+    {
+        temp[i-left].x=px[i];
+        temp[i-left].y=py[i];
+    }
+    std::sort(temp,temp+right-left+1,cmpxy);
+    for(i=left;i<=right;i++)
+    {
+        px[i]=temp[i-left].x;
+        py[i]=temp[i-left].y;
+    }
+    delete []temp;
 }
 
 double Pointpair::devide(int left,int right)
 {
-    double dmin=1e10,dl,dr;
-    int i,j;
+    double dmin=1e10,dl,dr,d;
+    int i,a;
     if(left==right) return dmin;                        //只有一个点时返回无限大
     if(left+1==right) return dis(left,right);           //只有两个点时返回该点对距离
     int mid=(left+right)/2;
@@ -42,7 +199,7 @@ double Pointpair::devide(int left,int right)
     else dmin=dr;                                       //选取左右区域更小的点
     for(i=left;i<=right;i++)                            //确定中间区域的最左结点编号
     {
-        if(fabs(points[mid].x-points[i].x)<=dmin)
+        if(fabs(px[mid]-px[i])<=dmin)
         {
             left=i;
             break;
@@ -50,7 +207,7 @@ double Pointpair::devide(int left,int right)
     }
     for(i=left;i<=right;i++)                            //确定中间区域的最右结点编号
     {
-        if(fabs(points[mid].x-points[i].x)>dmin)
+        if(fabs(px[mid]-px[i])>dmin)
         {
             right=i-1;
             break;
@@ -58,30 +215,274 @@ double Pointpair::devide(int left,int right)
     }
     if(mid==right) mid--;
     for(i=left;i<=mid;i++)                              //遍历该中间区域求得最近距离
-        for(j=mid+1;j<=right;j++)
-            if(dis(i,j)<dmin) dmin=dis(i,j);
+    {
+        d=sqmin(px[i],py[i],px+mid+1,py+mid+1,right-mid,a);
+        if(d<dmin*dmin) dmin=sqrt(d);
+    }
     return dmin;
 }
 
-double Pointpair::mindis()
+//按y合并的分治：order[left..right]返回时已按y排好序，中间区域每点只需检查其后常数个点
+//过程中全部使用距离平方，sqrt只在ydevide返回时计算一次
+double Pointpair::ydevidecore(int left,int right,int *order,int *temp,double *sx,double *sy,int &pl,int &pr)
+{
+    double dmin=1e300,d,midx;
+    int i,j,k,t,a,l1,r1,l2,r2;
+    if(right-left<3)                                    //不超过三个点时直接求解并按y插入排序
+    {
+        for(i=left;i<right;i++)
+            if((d=sqmin(px[i],py[i],px+i+1,py+i+1,right-i,a))<dmin)
+            {
+                dmin=d;
+                pl=i;
+                pr=i+1+a;
+            }
+        for(i=left;i<=right;i++)
+        {
+            t=i;
+            for(j=i-1;j>=left&&py[order[j]]>py[t];j--)
+                order[j+1]=order[j];
+            order[j+1]=t;
+        }
+        return dmin;
+    }
+    int mid=(left+right)/2;
+    midx=px[mid];
+    dmin=ydevidecore(left,mid,order,temp,sx,sy,l1,r1);
+    d=ydevidecore(mid+1,right,order,temp,sx,sy,l2,r2);
+    pl=l1;
+    pr=r1;
+    if(d<dmin)
+    {
+        dmin=d;
+        pl=l2;
+        pr=r2;
+    }
+    ymerge(order,temp,left,mid,mid+1,right,left);       //合并左右两半使order[left..right]按y有序
+    for(k=left;k<=right;k++)
+        order[k]=temp[k];
+    k=left;                                             //按y顺序取出中间区域的点，坐标连续存入sx/sy
+    for(i=left;i<=right;i++)
+        if((px[order[i]]-midx)*(px[order[i]]-midx)<dmin)
+        {
+            temp[k]=order[i];
+            sx[k]=px[order[i]];
+            sy[k]=py[order[i]];
+            k++;
+        }
+    return ystrip(left,k,k,temp,sx,sy,dmin,pl,pr);
+}
+
+//稳定合并src[a1..a2]与src[b1..b2]到dst[d..]，y相同时左半在前
+void Pointpair::ymerge(int *src,int *dst,int a1,int a2,int b1,int b2,int d)
 {
-    int i,j;
-    double mind=1e20;
-    for(i=0;i<pointnumber;i++)
-        for(j=i+1;j<pointnumber;j++)
+    while(a1<=a2&&b1<=b2)
+        dst[d++]=(py[src[b1]]<py[src[a1]])?src[b1++]:src[a1++];
+    while(a1<=a2) dst[d++]=src[a1++];
+    while(b1<=b2) dst[d++]=src[b1++];
+}
+
+//扫描中间区域第from到to-1个点，每点只与y差小于dmin的后继比较，至多7个（后继可越过to直到k）
+double Pointpair::ystrip(int from,int to,int k,int *temp,double *sx,double *sy,double dmin,int &pl,int &pr)
+{
+    double d;
+    int i,j,a;
+    for(i=from;i<to;i++)
+    {
+        for(j=i+1;j<k&&(sy[j]-sy[i])*(sy[j]-sy[i])<dmin;j++);
+        if(j>i+1&&(d=sqmin(sx[i],sy[i],sx+i+1,sy+i+1,j-i-1,a))<dmin)
         {
-            if(dis(i,j)<mind) 
+            dmin=d;
+            pl=temp[i];
+            pr=temp[i+1+a];
+        }
+    }
+    return dmin;
+}
+
+double Pointpair::ydevide(int left,int right)
+{
+    double dmin;
+    int pl,pr;
+    if(left>=right) return 1e20;
+    int *order=new int[right+1];
+    int *temp=new int[right+1];
+    double *sx=new double[right+1];
+    double *sy=new double[right+1];
+    dmin=ydevidecore(left,right,order,temp,sx,sy,pl,pr);
+    minl=pl;                                            //记录最近点对供printpos输出
+    minr=pr;
+    delete []order;
+    delete []temp;
+    delete []sx;
+    delete []sy;
+    return sqrt(dmin);
+}
+
+//并行合并：在较长一段取中位元素，二分确定其在另一段中的位置后两侧并行合并，结果与ymerge完全相同
+void Pointpair::pymerge(int *src,int *dst,int a1,int a2,int b1,int b2,int d)
+{
+    int na=a2-a1+1,nb=b2-b1+1,am,bm,lo,hi,md;
+    if(na+nb<=cutoff)
+    {
+        ymerge(src,dst,a1,a2,b1,b2,d);
+        return;
+    }
+    if(na>=nb)                                          //左段中位元素之前放入右段中y严格更小的元素
+    {
+        am=(a1+a2)/2;
+        lo=b1;
+        hi=b2+1;
+        while(lo<hi)
+        {
+            md=(lo+hi)/2;
+            if(py[src[md]]<py[src[am]]) lo=md+1;
+            else hi=md;
+        }
+        bm=lo;
+        dst[d+(am-a1)+(bm-b1)]=src[am];
+        #pragma omp task
+        pymerge(src,dst,a1,am-1,b1,bm-1,d);
+        pymerge(src,dst,am+1,a2,bm,b2,d+(am-a1)+(bm-b1)+1);
+    }
+    else                                                //右段中位元素之前放入左段中y不大于它的元素
+    {
+        bm=(b1+b2)/2;
+        lo=a1;
+        hi=a2+1;
+        while(lo<hi)
+        {
+            md=(lo+hi)/2;
+            if(py[src[md]]<=py[src[bm]]) lo=md+1;
+            else hi=md;
+        }
+        am=lo;
+        dst[d+(am-a1)+(bm-b1)]=src[bm];
+        #pragma omp task
+        pymerge(src,dst,a1,am-1,b1,bm-1,d);
+        pymerge(src,dst,am,a2,bm+1,b2,d+(am-a1)+(bm-b1)+1);
+    }
+    #pragma omp taskwait
+}
+
+//并行分治：左右子问题作为任务执行，规模不超过cutoff时转为串行ydevidecore
+//合并、中间区域筛选与扫描均按块并行，按块序归约，因此结果（含点对编号）与串行版本一致
+double Pointpair::pydevidecore(int left,int right,int *order,int *temp,double *sx,double *sy,int &pl,int &pr)
+{
+    double dmin,d,midx;
+    int c,k,l1,r1,l2,r2;
+    if(right-left+1<=cutoff)
+        return ydevidecore(left,right,order,temp,sx,sy,pl,pr);
+    int mid=(left+right)/2;
+    midx=px[mid];
+    #pragma omp task shared(dmin,l1,r1)
+    dmin=pydevidecore(left,mid,order,temp,sx,sy,l1,r1);
+    d=pydevidecore(mid+1,right,order,temp,sx,sy,l2,r2);
+    #pragma omp taskwait
+    pl=l1;
+    pr=r1;
+    if(d<dmin)
+    {
+        dmin=d;
+        pl=l2;
+        pr=r2;
+    }
+    pymerge(order,temp,left,mid,mid+1,right,left);
+    int chunks=(right-left+cutoff)/cutoff;              //按cutoff大小分块
+    int *cnt=new int[chunks+1];
+    double *cd=new double[chunks];
+    int *cl=new int[chunks],*cr=new int[chunks];
+    #pragma omp taskloop
+    for(c=0;c<chunks;c++)                               //各块拷回order并统计中间区域点数
+    {
+        int from=left+c*cutoff,to=min(right+1,from+cutoff),n=0;
+        for(int q=from;q<to;q++)
+        {
+            order[q]=temp[q];
+            if((px[temp[q]]-midx)*(px[temp[q]]-midx)<dmin) n++;
+        }
+        cnt[c+1]=n;
+    }
+    cnt[0]=left;
+    for(c=0;c<chunks;c++)
+        cnt[c+1]+=cnt[c];
+    k=cnt[chunks];
+    #pragma omp taskloop
+    for(c=0;c<chunks;c++)                               //各块按前缀和位置写入中间区域
+    {
+        int from=left+c*cutoff,to=min(right+1,from+cutoff),w=cnt[c];
+        for(int q=from;q<to;q++)
+            if((px[order[q]]-midx)*(px[order[q]]-midx)<dmin)
             {
-                mind=dis(i,j);
-                minl=i;
-                minr=j;
+                temp[w]=order[q];
+                sx[w]=px[order[q]];
+                sy[w]=py[order[q]];
+                w++;
             }
+    }
+    #pragma omp taskloop
+    for(c=0;c<chunks;c++)                               //各块独立扫描中间区域
+    {
+        int from=left+c*cutoff,to=min(k,from+cutoff);
+        cl[c]=cr[c]=-1;
+        cd[c]=(from<to)?ystrip(from,to,k,temp,sx,sy,dmin,cl[c],cr[c]):dmin;
+    }
+    for(c=0;c<chunks;c++)                               //按块序归约，与串行扫描顺序一致
+        if(cd[c]<dmin)
+        {
+            dmin=cd[c];
+            pl=cl[c];
+            pr=cr[c];
+        }
+    delete []cnt;
+    delete []cd;
+    delete []cl;
+    delete []cr;
+    return dmin;
+}
+
+double Pointpair::pydevide(int left,int right)
+{
+    double dmin;
+    int pl,pr;
+    if(left>=right) return 1e20;
+    if(cutoff<64) cutoff=64;                            //过小时递归不终止（规模1<=0不成立）且分块除零，任务也过细
+    int *order=new int[right+1];
+    int *temp=new int[right+1];
+    double *sx=new double[right+1];
+    double *sy=new double[right+1];
+    #pragma omp parallel
+    #pragma omp single
+    dmin=pydevidecore(left,right,order,temp,sx,sy,pl,pr);
+    minl=pl;
+    minr=pr;
+    delete []order;
+    delete []temp;
+    delete []sx;
+    delete []sy;
+    return sqrt(dmin);
+}
+
+double Pointpair::mindis()
+{
+    int i,a;
+    double mind=1e300,d;
+    for(i=0;i+1<pointnumber;i++)
+    {
+        d=sqmin(px[i],py[i],px+i+1,py+i+1,pointnumber-i-1,a);
+        if(d<mind)
+        {
+            mind=d;
+            minl=i;
+            minr=i+1+a;
         }
-    return mind;
+    }
+    if(pointnumber<2) return 1e20;
+    return sqrt(mind);
 }
 
 void Pointpair::printpos()
 {
-    printf("x1=%lf,y1=%lf\n",points[minl].x,points[minl].y);
-    printf("x2=%lf,y2=%lf\n",points[minr].x,points[minr].y);
-}
\ No newline at end of file
+    printf("x1=%lf,y1=%lf\n",px[minl],py[minl]);
+    printf("x2=%lf,y2=%lf\n",px[minr],py[minr]);
+}
@@ -1,25 +1,61 @@
+#ifndef POINTPAIR_H
+#define POINTPAIR_H
 #include <iostream>
 #include <math.h>
 #include <cstdio> 
 #include <algorithm>
+#include "Dynpair.h"
 using namespace std;
 typedef struct 
 {
     double x;
     double y;
 } Point;
+enum engine{
+    enginebrute=0,                                      //暴力法mindis
+    enginedevide=1,                                     //按y合并的分治ydevide
+    engineparallel=2,                                   //并行分治pydevide
+    enginegrid=3                                        //随机网格法griddis
+};
 class Pointpair
 {
 private:
-    Point *points;
+    double *px,*py;                                     //结构数组分离存储：x[]与y[]各自连续
+    int capacity;                                       //当前已分配的点数，满时自动倍增
     int minl,minr;
+    double ydevidecore(int left,int right,int *order,int *temp,double *sx,double *sy,int &pl,int &pr);
+    void ymerge(int *src,int *dst,int a1,int a2,int b1,int b2,int d);
+    double ystrip(int from,int to,int k,int *temp,double *sx,double *sy,double dmin,int &pl,int &pr);
+    double pydevidecore(int left,int right,int *order,int *temp,double *sx,double *sy,int &pl,int &pr);
+    void pymerge(int *src,int *dst,int a1,int a2,int b1,int b2,int d);
+    double sqmin(double x,double y,const double *bx,const double *by,int n,int &arg);
 public:
     int pointnumber;
+    bool usesimd;                                       //距离核是否使用向量指令
+    int cutoff;                                         //并行分治中转为串行处理的规模，不足64时按64
+    Dynpair *dynall,*dynwin;                            //Addpoint时动态维护的全体与滑动窗口最近点对
     Pointpair(int maxpoint);
+    ~Pointpair();
+    double getx(int i) {return px[i];}
+    double gety(int i) {return py[i];}
     double dis(int p1,int p2);
+    double dis2(int p1,int p2);
+    void reserve(int n);
     void Addpoint(double x,double y);
+    void Addpoints(const double *x,const double *y,int n);
+    void Removepoints(int k);
+    void trackpairs(int window);
+    bool loadfile(const char *file);
+    bool savebinary(const char *file);
     void pointsort(int left,int right);
     double devide(int left,int right);
+    double ydevide(int left,int right);
+    double pydevide(int left,int right);
     double mindis();
+    double griddis();
+    double closest(int engine);
     void printpos();
-};
\ No newline at end of file
+    void getpair(int &a,int &b) {a=minl;b=minr;}
+};
+
+#endif
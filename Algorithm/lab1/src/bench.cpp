@@ -0,0 +1,140 @@
+#include "Pointpair.h"
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+using namespace std;
+
+//最近点对性能测试：四种分布 x 各规模 x 各算法，每次测量在子进程中完成以得到各自的峰值内存
+//输出为每行一个JSON对象，包含耗时、每秒处理点数与峰值常驻内存（KB）
+//用法：./bench [最大点数，默认1000000] [分布名，默认全部]
+static const char *dists[]={"uniform","clustered","collinear","duplicate"};
+static const char *engines[]={"mindis_scalar","mindis","devide","ydevide_scalar","ydevide","pydevide","griddis"};
+
+//按分布生成n个点：均匀、高斯簇、全部x相同（中间区域最坏情况）、大量重复点
+static void generate(Pointpair &PP,int dist,long long n)
+{
+    mt19937_64 gen(2334+n);
+    uniform_real_distribution<double> u(0,(double)n);
+    long long i;
+    if(dist==0)
+        for(i=0;i<n;i++)
+            PP.Addpoint(u(gen),u(gen));
+    else if(dist==1)
+    {
+        int c=(int)(n/1000)+1;
+        vector<double> cx(c),cy(c);
+        normal_distribution<double> g(0,1.0);
+        for(i=0;i<c;i++)
+        {
+            cx[i]=u(gen);
+            cy[i]=u(gen);
+        }
+        for(i=0;i<n;i++)
+        {
+            int k=gen()%c;
+            PP.Addpoint(cx[k]+g(gen),cy[k]+g(gen));
+        }
+    }
+    else if(dist==2)
+        for(i=0;i<n;i++)
+            PP.Addpoint(0,u(gen));
+    else
+    {
+        long long m=n/10+1;
+        vector<double> px(m),py(m);
+        for(i=0;i<m;i++)
+        {
+            px[i]=u(gen);
+            py[i]=u(gen);
+        }
+        for(i=0;i<n;i++)
+        {
+            long long k=gen()%m;
+            PP.Addpoint(px[k],py[k]);
+        }
+    }
+}
+
+//暴力法只测小规模；旧的devide在中间区域为平方复杂度，x全相同时只测小规模
+static bool feasible(int dist,int eng,long long n)
+{
+    if(eng<=1) return n<=10000;
+    if(eng==2) return dist==2?n<=10000:n<=1000000;
+    return true;
+}
+
+static double run(Pointpair &PP,int eng)
+{
+    int n=PP.pointnumber;
+    switch(eng)
+    {
+        case 0:
+            PP.usesimd=false;
+            return PP.closest(enginebrute);
+        case 1:
+            return PP.closest(enginebrute);
+        case 2:
+            PP.pointsort(0,n-1);
+            return PP.devide(0,n-1);
+        case 3:
+            PP.usesimd=false;
+            return PP.closest(enginedevide);
+        case 4:
+            return PP.closest(enginedevide);
+        case 5:
+            return PP.closest(engineparallel);
+        default:
+            return PP.closest(enginegrid);
+    }
+}
+
+int main(int argc,char *argv[])
+{
+    long long maxn=(argc>1)?atoll(argv[1]):1000000,n;
+    int dist,eng;
+    for(dist=0;dist<4;dist++)
+    {
+        if(argc>2&&strcmp(argv[2],dists[dist])!=0) continue;
+        for(n=1000;n<=maxn;n*=10)
+            for(eng=0;eng<7;eng++)
+            {
+                if(!feasible(dist,eng,n)) continue;
+                int fd[2];
+                if(pipe(fd)<0) return 1;
+                fflush(stdout);
+                pid_t pid=fork();
+                if(pid==0)                              //子进程：生成数据并计时，结果经管道传回
+                {
+                    close(fd[0]);
+                    Pointpair PP(n);
+                    generate(PP,dist,n);
+                    chrono::steady_clock::time_point t0=chrono::steady_clock::now();
+                    double d=run(PP,eng);
+                    double t=chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+                    double res[2]={t,d};
+                    if(write(fd[1],res,sizeof(res))!=sizeof(res)) _exit(1);
+                    _exit(0);
+                }
+                close(fd[1]);
+                double res[2];
+                struct rusage ru;
+                bool ok=read(fd[0],res,sizeof(res))==sizeof(res);
+                close(fd[0]);
+                int status;
+                wait4(pid,&status,0,&ru);
+                if(!ok||!WIFEXITED(status)||WEXITSTATUS(status)!=0)
+                {
+                    printf("{\"dist\":\"%s\",\"n\":%lld,\"engine\":\"%s\",\"error\":true}\n",dists[dist],n,engines[eng]);
+                    continue;
+                }
+                printf("{\"dist\":\"%s\",\"n\":%lld,\"engine\":\"%s\",\"seconds\":%.6f,\"points_per_sec\":%.0f,"
+                    "\"peak_rss_kb\":%ld,\"distance\":%.17g}\n",dists[dist],n,engines[eng],res[0],
+                    res[0]>0?n/res[0]:0,ru.ru_maxrss,res[1]);
+            }
+    }
+    return 0;
+}
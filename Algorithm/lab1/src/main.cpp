@@ -1,6 +1,8 @@
 #include <iostream>
-#include "Pointpair.h"
+#include "Kdtree.h"
+#include "Extpair.h"
 #include <stdlib.h>
+#include <string.h>
 #include <fstream>
 #include <sstream>
 #define numsize 5000
@@ -11,19 +13,56 @@ using namespace std;
 int main(int argc,char *argv[])
 {
     int maxnumber=10000;
-    int i,m;
-    double x,y;
-    char k;
+    int i,eng=enginedevide,kpair=0;
+    const char *binout=NULL;
+    long long extbudget=0;
     Pointpair PP(maxnumber);
     srand((unsigned)time(NULL));
-    ifstream in(argv[1]);
-    //printf("%d",in.eof());
-    while(!in.eof())
+    for(i=2;i+1<argc;i+=2)                              //-e选择算法，-o另存为二进制点文件，-k输出最近的k个点对，-w维护滑动窗口，-x外存模式
     {
-       
-        in>>x>>k>>y>>k;
-        //printf("x=%lf,y=%lf\n",x,y);
-        PP.Addpoint(x,y);
+        if(strcmp(argv[i],"-o")==0) binout=argv[i+1];
+        else if(strcmp(argv[i],"-k")==0) kpair=atoi(argv[i+1]);
+        else if(strcmp(argv[i],"-w")==0) PP.trackpairs(atoi(argv[i+1]));
+        else if(strcmp(argv[i],"-x")==0) extbudget=atoll(argv[i+1])<<20;
+        else if(strcmp(argv[i],"-e")==0)
+        {
+            if(strcmp(argv[i+1],"brute")==0) eng=enginebrute;
+            else if(strcmp(argv[i+1],"devide")==0) eng=enginedevide;
+            else if(strcmp(argv[i+1],"parallel")==0) eng=engineparallel;
+            else if(strcmp(argv[i+1],"grid")==0) eng=enginegrid;
+        }
+    }
+    if(argc>=2&&extbudget>0)                            //外存模式：不读入内存，按MB预算处理二进制点文件
+    {
+        double x1,y1,x2,y2,d=extclosest(argv[1],extbudget,x1,y1,x2,y2);
+        if(d<0)
+        {
+            cout<<(d<-1.5?"Can't write the temporary files!":"Can't read the binary point file!")<<endl;
+            return 1;
+        }
+        cout<<"The closet distance is "<<d<<endl;
+        cout<<"The point position:"<<endl;
+        printf("x1=%lf,y1=%lf\nx2=%lf,y2=%lf\n",x1,y1,x2,y2);
+        return 0;
+    }
+    if(argc<2||!PP.loadfile(argv[1]))                   //文本或二进制点文件，存储随读入自动扩充
+    {
+        cout<<"Can't read the point file!"<<endl;
+        return 1;
+    }
+    if(binout!=NULL)
+        PP.savebinary(binout);
+    if(PP.dynwin!=NULL||PP.dynall!=NULL)                //读入过程中动态维护的最后window个点（-w 0时为全部点）的最近点对
+    {
+        Dynpair *dyn=(PP.dynwin!=NULL)?PP.dynwin:PP.dynall;
+        long long a,b;
+        double x1,y1,x2,y2;
+        cout<<"The closet distance of the "<<(PP.dynwin!=NULL?"last points":"inserted points")<<" is "<<dyn->closest(a,b)<<endl;
+        if(a>=0)
+        {
+            dyn->pairpos(x1,y1,x2,y2);
+            printf("x1=%lf,y1=%lf\nx2=%lf,y2=%lf\n",x1,y1,x2,y2);
+        }
     }
     /*cout<<"Please input the points' total number:"<<endl;
     cin>>maxnumber;
@@ -48,9 +87,20 @@ int main(int argc,char *argv[])
             PP.Addpoint(x,y);
         }
     }*/
-    PP.pointsort(0,PP.pointnumber-1);
+    if(kpair>0)                                         //借助k-d树求最近的k个点对
+    {
+        vector<Kdpair> pairs;
+        Kdtree kd(PP);
+        kd.kclosest(kpair,pairs);
+        for(i=0;i<(int)pairs.size();i++)
+            printf("%lf (%lf,%lf)-(%lf,%lf)\n",pairs[i].d,PP.getx(pairs[i].a),PP.gety(pairs[i].a),
+                PP.getx(pairs[i].b),PP.gety(pairs[i].b));
+        return 0;
+    }
+    //PP.pointsort(0,PP.pointnumber-1);
     //cout<<"The closet distance is "<<PP.mindis()<<endl;
-    cout<<"The closet distance is "<<PP.devide(0,PP.pointnumber)<<endl;
+    //cout<<"The closet distance is "<<PP.devide(0,PP.pointnumber-1)<<endl;
+    cout<<"The closet distance is "<<PP.closest(eng)<<endl;
     cout<<"The point position:"<<endl;
     PP.printpos();
 }
\ No newline at end of file
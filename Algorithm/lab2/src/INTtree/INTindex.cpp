@@ -0,0 +1,175 @@
+#include "INTindex.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#if defined(__x86_64__)||defined(__i386__)
+#include <immintrin.h>
+#define IX_X86
+#endif
+
+INTindex::INTindex(INTtree &T)
+{
+    int i;
+    vector<interval> v;
+    n=T.INTintervals(v);
+    for(depth=0;(1<<depth)-1<n;depth++);                //Eytzinger树的层数
+    size_t bytes=((size_t)(n+1)*sizeof(int)+63)/64*64;
+    ek=(int*)aligned_alloc(64,bytes);                   //按缓存行对齐，使ek[16k..16k+15]落在同一行
+    erank=new int[n+1];
+    lows=new int[n];
+    highs=new int[n];
+    pmax=new int[n];
+    parg=new int[n];
+    smax=new int[n];
+    for(i=0;i<n;i++)
+    {
+        lows[i]=v[i].low;
+        highs[i]=v[i].high;
+        if(i==0||highs[i]>pmax[i-1])
+        {
+            pmax[i]=highs[i];
+            parg[i]=i;
+        }
+        else
+        {
+            pmax[i]=pmax[i-1];
+            parg[i]=parg[i-1];
+        }
+    }
+    ek[0]=0;
+    erank[0]=n;
+    eytzbuild(1,0);
+    smaxbuild(0,n);
+    usesimd=true;
+}
+
+INTindex::~INTindex()
+{
+    free(ek);
+    delete []erank;
+    delete []lows;
+    delete []highs;
+    delete []pmax;
+    delete []parg;
+    delete []smax;
+}
+
+int INTindex::size()
+{
+    return n;
+}
+
+interval INTindex::get(int i)
+{
+    interval x;
+    x.low=lows[i];
+    x.high=highs[i];
+    return x;
+}
+
+//中序填入Eytzinger排列：结点k的左右孩子为2k、2k+1
+int INTindex::eytzbuild(int k,int i)
+{
+    if(k<=n)
+    {
+        i=eytzbuild(2*k,i);
+        ek[k]=lows[i];
+        erank[k]=i++;
+        i=eytzbuild(2*k+1,i);
+    }
+    return i;
+}
+
+int INTindex::smaxbuild(int l,int r)
+{
+    if(l>=r) return INT_MIN;
+    int m=(l+r)/2;
+    smax[m]=max(highs[m],max(smaxbuild(l,m),smaxbuild(m+1,r)));
+    return smax[m];
+}
+
+//low<x的区间个数。下降时k的二进制位记录每层走向，末尾连续的1是最后一次向左之后的右转，
+//去掉它们和那次向左即得第一个low>=x的结点；提前取4层之后的16个后代所在的缓存行
+int INTindex::countless(int x)
+{
+    int k=1;
+    while(k<=n)
+    {
+        __builtin_prefetch(ek+k*16);
+        k=2*k+(ek[k]<x);
+    }
+    k>>=__builtin_ffs(~k);
+    return erank[k];
+}
+
+//与INTSearch相同：返回与(low,high)相交的某个区间的编号，没有则返回-1。
+//low<high的区间构成一个前缀，其中high最大者若不大于low则无相交区间
+int INTindex::search(int low,int high)
+{
+    int c=countless(high);
+    if(c>0&&pmax[c-1]>low) return parg[c-1];
+    return -1;
+}
+
+#ifdef IX_X86
+//8个查询同步下降：每层一次gather，已走出树的通道下标保持不变
+__attribute__((target("avx2")))
+static void countlessavx2(const int *ek,int n,int depth,const int *x,int *k)
+{
+    int d;
+    __m256i vx=_mm256_loadu_si256((const __m256i*)x);
+    __m256i vk=_mm256_set1_epi32(1);
+    __m256i vn=_mm256_set1_epi32(n+1);
+    for(d=0;d<depth;d++)
+    {
+        __m256i live=_mm256_cmpgt_epi32(vn,vk);
+        __m256i e=_mm256_i32gather_epi32(ek,_mm256_and_si256(vk,live),4);
+        __m256i lt=_mm256_cmpgt_epi32(vx,e);
+        __m256i nk=_mm256_sub_epi32(_mm256_add_epi32(vk,vk),lt);
+        vk=_mm256_blendv_epi8(vk,nk,live);
+    }
+    _mm256_storeu_si256((__m256i*)k,vk);
+}
+#endif
+
+//批量执行search，res[i]为第i个查询的结果
+void INTindex::searchbatch(const int *low,const int *high,int m,int *res)
+{
+    int i=0,j,c;
+#ifdef IX_X86
+    static const bool hasavx2=__builtin_cpu_supports("avx2");
+    int k[8];
+    if(usesimd&&hasavx2)
+        for(;i+8<=m;i+=8)
+        {
+            countlessavx2(ek,n,depth,high+i,k);
+            for(j=0;j<8;j++)
+            {
+                c=erank[k[j]>>__builtin_ffs(~k[j])];
+                res[i+j]=(c>0&&pmax[c-1]>low[i+j])?parg[c-1]:-1;
+            }
+        }
+#endif
+    for(;i<m;i++)
+        res[i]=search(low[i],high[i]);
+}
+
+void INTindex::collect(int l,int r,int low,int high,vector<int> &out)
+{
+    if(l>=r) return;
+    int m=(l+r)/2;
+    if(smax[m]<=low) return;
+    collect(l,m,low,high,out);
+    if(lows[m]>=high) return;
+    if(highs[m]>low)
+        out.push_back(m);
+    collect(m+1,r,low,high,out);
+}
+
+//与INTSearchAll相同：按low升序追加全部相交区间的编号，返回个数
+int INTindex::searchall(int low,int high,vector<int> &out)
+{
+    size_t old=out.size();
+    collect(0,n,low,high,out);
+    return out.size()-old;
+}
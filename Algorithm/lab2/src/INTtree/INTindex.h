@@ -0,0 +1,29 @@
+#ifndef INTINDEX_H
+#define INTINDEX_H
+#include "INTtree.h"
+
+//由INTtree冻结得到的只读区间索引，建好后与原树无关，原树再增删需重新冻结
+//区间按low升序编号：ek为low的Eytzinger（BFS）排列，查low<high的区间个数时逐层下标翻倍，无指针、无分支；
+//pmax/parg为前缀最大high及其位置，search与INTSearch回答相同的查询；
+//smax为以区间[l,r)中位为结点的隐式平衡树上的子树最大high，searchall据此剪枝
+class INTindex
+{
+public:
+    INTindex(INTtree &T);
+    ~INTindex();
+    int size();
+    interval get(int i);
+    int search(int low,int high);
+    void searchbatch(const int *low,const int *high,int m,int *res);
+    int searchall(int low,int high,vector<int> &out);
+    bool usesimd;                                       //searchbatch是否使用AVX2
+private:
+    int n,depth;
+    int *ek,*erank;                                     //ek[1..n]为Eytzinger排列，erank[k]为ek[k]的升序编号，erank[0]=n
+    int *lows,*highs,*pmax,*parg,*smax;
+    int eytzbuild(int k,int i);
+    int smaxbuild(int l,int r);
+    int countless(int x);
+    void collect(int l,int r,int low,int high,vector<int> &out);
+};
+#endif
@@ -1,4 +1,6 @@
 #include "INTtree.h"
+#include <algorithm>
+#include <vector>
 /*tree::tree(int low,int high)
 {
     inter.low=low;
@@ -9,28 +11,30 @@
 INTtree::INTtree()
 {
     nil=new tree;
-    nil->inter=new interval;
-    nil->inter->low=NIL;
-    nil->inter->high=NIL+1;
-    nil->data=nil->inter->low;
-    nil->max=nil->inter->high;
+    nil->inter.low=NIL;
+    nil->inter.high=NIL+1;
+    nil->data=nil->inter.low;
+    nil->max=nil->inter.high;
     nil->left=NULL;
     nil->right=NULL;
     nil->col=black;
     nil->p=NULL;
     root=nil;
     total=0;
-    outnum=0;
+}
+
+INTtree::~INTtree()
+{
+    delete nil;
 }
   
 tree* INTtree::INTtreenode(int low,int high)
 {
-    tree *node=new tree;
-    node->inter=new interval;
-    node->inter->low=low;
-    node->inter->high=high;
-    node->data=node->inter->low;
-    node->max=node->inter->high;
+    tree *node=pool.alloc();
+    node->inter.low=low;
+    node->inter.high=high;
+    node->data=node->inter.low;
+    node->max=node->inter.high;
     node->left=nil;
     node->right=nil;
     node->col=black;
@@ -51,8 +55,8 @@ void INTtree::set_max(tree *z)
     if(z->left->max>z->right->max)
         max=z->left->max;
     else max=z->right->max;
-    if(max<z->inter->high)
-        max=z->inter->high;
+    if(max<z->inter.high)
+        max=z->inter.high;
     z->max=max;
 }
 
@@ -185,14 +189,77 @@ void INTtree::insertfixcolor(tree *z)
 
 bool INTtree::INTinsert(int low,int max)
 { 
+    if(root==nil)                                       //空树时直接建根
+    {
+        createtree(low,max);
+        return true;
+    }
     tree *z=insertnode(root,low,max);
     if (z==NULL) return false;
     set_max(z);
+    for(tree *y=z->p;y!=nil;y=y->p)                     //沿插入路径向上更新max
+        set_max(y);
     insertfixcolor(z);
     total++;
     return true;
 }
 
+void INTtree::freetree(tree *x)
+{
+    if(x==NULL||x==nil) return;
+    freetree(x->left);
+    freetree(x->right);
+    pool.release(x);
+}
+
+//与RBtree::bulkbuild相同的中点建树与染色，子树建好后自底向上计算max
+tree* INTtree::bulkbuild(interval *items,int l,int r,int depth,int reddepth,tree *par)
+{
+    if(l>r) return nil;
+    int mid=(l+r)/2;
+    tree *x=INTtreenode(items[mid].low,items[mid].high);
+    x->p=par;
+    x->col=(depth==reddepth)?red:black;
+    x->left=bulkbuild(items,l,mid-1,depth+1,reddepth,x);
+    x->right=bulkbuild(items,mid+1,r,depth+1,reddepth,x);
+    set_max(x);
+    return x;
+}
+
+static bool cmplow(const interval &a,const interval &b)
+{
+    return a.low<b.low;
+}
+
+//由区间数组线性时间建树，替换原有的树；sorted为false时先按low排序，low相同的区间只保留第一个
+//sorted为true但数组实际无序时返回false，原树不变
+bool INTtree::INTbulkload(interval *items,int n,bool sorted)
+{
+    int i,m,h;
+    if(n<0) return false;
+    interval *buf=new interval[n+1];
+    for(i=0;i<n;i++)
+        buf[i]=items[i];
+    if(!sorted)
+        std::stable_sort(buf,buf+n,cmplow);
+    for(i=m=0;i<n;i++)
+    {
+        if(m>0&&buf[i].low<buf[m-1].low)
+        {
+            delete []buf;
+            return false;
+        }
+        if(m==0||buf[i].low!=buf[m-1].low)
+            buf[m++]=buf[i];
+    }
+    freetree(root);
+    for(h=0;(2<<h)-1<m;h++);                            //h为最底层深度
+    root=bulkbuild(buf,0,m-1,0,((2<<h)-1==m)?-1:h,nil);
+    total=m;
+    delete []buf;
+    return true;
+}
+
 void INTtree::INTTransplant(tree *u,tree *v)
 {    
     if (u->p == nil)
@@ -246,8 +313,11 @@ void INTtree::INTnodeDelete(tree *z)
         y->left->p = y;
         y->col = z->col;
     }
+    for(tree *u=x->p;u!=nil;u=u->p)                     //从被摘除位置向上更新max，之后的旋转自行维护
+        set_max(u);
     if (y_original_color == black)
         INTnodeDeleteFixup(x);
+    pool.release(z);
 }
 
 void INTtree::INTnodeDeleteFixup(tree *x)
@@ -328,49 +398,113 @@ bool INTtree::INTDelete(int low,int high)
     return true;
 }
 
-void INTtree::treepreorderTraversal(tree *nextnode)
+//迭代式遍历：借助父指针逐个取下一个结点，不用递归和缓冲区，遍历结束时返回NULL
+tree* INTtree::inbegin()
+{
+    if(root==nil) return NULL;
+    return TreeMinimum(root);
+}
+
+tree* INTtree::innext(tree *x)
 {
-    //ofstream out;
-    if(nextnode==nil) return;
-    outtree[0][outnum]=nextnode->data;
-    outtree[1][outnum]=nextnode->col;
-    outnum++;
-    //cout<<outnum;
-    treepreorderTraversal(nextnode->left);
-    treepreorderTraversal(nextnode->right);
-    //out->open("tree_out->txt",ios::app);
-    //out->close();
+    x=TreeSuccessor(x);
+    return (x==nil)?NULL:x;
+}
+
+tree* INTtree::prebegin()
+{
+    if(root==nil) return NULL;
+    return root;
 }
 
-void INTtree::treeinorderTraversal(tree *nextnode)
+//先序的下一个结点：有孩子时取孩子，否则向上找到第一个从左边回来且有右孩子的祖先
+tree* INTtree::prenext(tree *x)
 {
-    if(nextnode==nil) return;
-    treeinorderTraversal(nextnode->left);
-    
-    outtree[2][outnum]=nextnode->data;
-    outnum++;
-    treeinorderTraversal(nextnode->right);
+    if(x->left!=nil) return x->left;
+    if(x->right!=nil) return x->right;
+    for(tree *y=x->p;y!=nil;x=y,y=y->p)
+        if(x==y->left&&y->right!=nil)
+            return y->right;
+    return NULL;
 }
 
+//输出vis_tree的输入文件：结点数、先序关键字、先序颜色、中序关键字
 void INTtree::printtree()
 {
     ofstream out;
-    int i,j;
+    tree *x;
     out.open("input.txt");
-    outnum=0;
-    treepreorderTraversal(root);
-    outnum=0;
-    treeinorderTraversal(root);
     out<<total<<endl;
-    for(j=0;j<3;j++)
+    for(x=prebegin();x!=NULL;x=prenext(x))
+        out<<x->data<<' ';
+    out<<endl;
+    for(x=prebegin();x!=NULL;x=prenext(x))
+        out<<x->col<<' ';
+    out<<endl;
+    for(x=inbegin();x!=NULL;x=innext(x))
+        out<<x->data<<' ';
+    out<<endl;
+    out.close();
+}
+
+int INTtree::heightnode(tree *x)
+{
+    if(x==nil) return 0;
+    return 1+max(heightnode(x->left),heightnode(x->right));
+}
+
+//树高（根到最深叶子的结点数），空树为0
+int INTtree::height()
+{
+    if(root==nil) return 0;
+    return heightnode(root);
+}
+
+int INTtree::gettotal()
+{
+    return total;
+}
+
+//边遍历边写出DOT文件，格式同vis_tree的输出，可直接交给dot作图
+bool INTtree::exportdot(const char *file)
+{
+    ofstream out(file);
+    tree *x;
+    if(!out) return false;
+    out<<"digraph first2{"<<endl;
+    for(x=prebegin();x!=NULL;x=prenext(x))
     {
-        for(i=0;i<total;i++)
-        {
-            out<<outtree[j][i]<<' ';
-        }
-        out<<endl;
+        out<<x->data<<" [label=\"["<<x->inter.low<<","<<x->inter.high<<"] "<<x->max<<"\" color="<<(x->col==red?"\"red\"":"\"black\"")<<"];"<<endl;
+        if(x->left!=nil) out<<x->data<<"->"<<x->left->data<<";"<<endl;
+        if(x->right!=nil) out<<x->data<<"->"<<x->right->data<<";"<<endl;
     }
-    out.close();
+    out<<"}"<<endl;
+    return true;
+}
+
+//边遍历边写出JSON：按先序排列的结点数组，孩子以关键字表示，没有孩子为null
+bool INTtree::exportjson(const char *file)
+{
+    ofstream out(file);
+    tree *x;
+    if(!out) return false;
+    out<<"{\"root\":";
+    if(prebegin()==NULL) out<<"null";
+    else out<<root->data;
+    out<<",\"nodes\":[";
+    for(x=prebegin();x!=NULL;x=prenext(x))
+    {
+        out<<(x==root?"\n":",\n")<<"{\"key\":"<<x->data<<",\"low\":"<<x->inter.low<<",\"high\":"<<x->inter.high<<",\"max\":"<<x->max<<",\"color\":"<<(x->col==red?"\"red\"":"\"black\"");
+        out<<",\"left\":";
+        if(x->left==nil) out<<"null";
+        else out<<x->left->data;
+        out<<",\"right\":";
+        if(x->right==nil) out<<"null";
+        else out<<x->right->data;
+        out<<"}";
+    }
+    out<<"]}"<<endl;
+    return true;
 }
 
 tree* INTtree::SearchINTnode(tree *per,int low,int high)
@@ -378,7 +512,7 @@ tree* INTtree::SearchINTnode(tree *per,int low,int high)
     if(per==nil) return NULL;
     if(per->data==low) 
     {
-        if(per->inter->high==high)
+        if(per->inter.high==high)
             return per;
         else return NULL;
     }
@@ -390,11 +524,87 @@ tree* INTtree::SearchINTnode(tree *per,int low,int high)
 tree* INTtree::INTSearch(int low,int high)
 {
     tree *x=root; 
-    while ((x!=nil)&&((low >= x->inter->high)||(high <= x->inter->low)))
-        if ((x->left!=nil)&&(x->left->max>=low))
+    while ((x!=nil)&&((low >= x->inter.high)||(high <= x->inter.low)))
+        if ((x->left!=nil)&&(x->left->max>low))
             x=x->left;
         else
             x=x->right;
     if(x==nil) return NULL;
     return x;
 }
+
+tree* INTtree::TreeSuccessor(tree *x)
+{
+    if(x->right!=nil) return TreeMinimum(x->right);
+    tree *y=x->p;
+    while(y!=nil&&x==y->right)
+    {
+        x=y;
+        y=y->p;
+    }
+    return y;
+}
+
+//按max剪枝的中序遍历：子树max<=low时整棵子树都不与查询相交；结点low>=high时其右子树都不相交
+void INTtree::overlapcollect(tree *x,int low,int high,vector<tree*> &out)
+{
+    if(x==nil||x->max<=low) return;
+    overlapcollect(x->left,low,high,out);
+    if(low<x->inter.high&&high>x->inter.low)
+        out.push_back(x);
+    if(x->inter.low<high)
+        overlapcollect(x->right,low,high,out);
+}
+
+//找出与(low,high)相交的全部区间，按low升序追加到out，返回个数；访问结点数为O(min(n,k*log n))
+int INTtree::INTSearchAll(int low,int high,vector<tree*> &out)
+{
+    size_t old=out.size();
+    overlapcollect(root,low,high,out);
+    return out.size()-old;
+}
+
+//按low升序导出全部区间，追加到out，返回个数
+int INTtree::INTintervals(vector<interval> &out)
+{
+    size_t old=out.size();
+    for(tree *x=(root==nil)?nil:TreeMinimum(root);x!=nil;x=TreeSuccessor(x))
+        out.push_back(x->inter);
+    return out.size()-old;
+}
+
+static bool cmphigh(tree *a,tree *b)
+{
+    return a->inter.high>b->inter.high;
+}
+
+//批量点查询：对每个points[i]找出满足low<points[i]<high的全部区间（与INTSearch(p,p)一致），
+//结果以(i,结点)追加到out。查询点排序后与按low有序的区间一次扫描，以high为键的小根堆维护当前覆盖的区间，
+//总时间O((n+m)log n+k)
+void INTtree::INTStabBatch(int *points,int m,vector<pair<int,tree*> > &out)
+{
+    int i;
+    vector<int> order(m);
+    for(i=0;i<m;i++)
+        order[i]=i;
+    sort(order.begin(),order.end(),[points](int a,int b){return points[a]<points[b];});
+    vector<tree*> active;
+    tree *x=(root==nil)?nil:TreeMinimum(root);
+    for(i=0;i<m;i++)
+    {
+        int q=points[order[i]];
+        while(x!=nil&&x->inter.low<q)                   //加入起点在q之前的区间
+        {
+            active.push_back(x);
+            push_heap(active.begin(),active.end(),cmphigh);
+            x=TreeSuccessor(x);
+        }
+        while(!active.empty()&&active.front()->inter.high<=q)
+        {
+            pop_heap(active.begin(),active.end(),cmphigh);
+            active.pop_back();
+        }
+        for(size_t k=0;k<active.size();k++)
+            out.push_back(make_pair(order[i],active[k]));
+    }
+}
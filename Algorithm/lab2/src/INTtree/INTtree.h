@@ -1,6 +1,10 @@
+#ifndef INTTREE_H
+#define INTTREE_H
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <vector>
+#include "Nodepool.h"
 #define NIL -10000
 using namespace std;
 
@@ -16,7 +20,7 @@ typedef struct interval{
 } interval;
 
 typedef struct tree{
-    interval *inter;
+    interval inter;                                     //区间直接存于结点内
     int data;
     int max;
     color col;
@@ -25,24 +29,34 @@ typedef struct tree{
 
 class INTtree{
 public:
-    int outtree[3][100];
-    int outnum;
     INTtree();
+    ~INTtree();
     tree *INTtreenode(int low,int high);
     tree *createtree(int low,int high);
     void set_max(tree *z);
     bool INTinsert(int low,int max);
+    bool INTbulkload(interval *items,int n,bool sorted);
     void INTnodeDelete(tree *z);
     tree *SearchINTnode(tree *per,int low,int high);
     bool INTDelete(int low,int high);
-    void treeinorderTraversal(tree *nextnode);
-    void treepreorderTraversal(tree *nextnode);
+    tree *inbegin();
+    tree *innext(tree *x);
+    tree *prebegin();
+    tree *prenext(tree *x);
     void printtree();
+    int height();
+    int gettotal();
+    bool exportdot(const char *file);
+    bool exportjson(const char *file);
     tree *INTSearch(int low,int high);
+    int INTSearchAll(int low,int high,vector<tree*> &out);
+    void INTStabBatch(int *points,int m,vector<pair<int,tree*> > &out);
+    int INTintervals(vector<interval> &out);
 private:
     tree *root;
     tree *nil;
     int total;
+    Nodepool<tree> pool;                                //结点池，结点成块分配并复用已删除结点
     void leftrotate(tree *x);
     void rightrotate(tree *x);
     tree* insertnode(tree* par,int low,int high);
@@ -50,4 +64,10 @@ private:
     void INTnodeDeleteFixup(tree *x);
     void INTTransplant(tree *u,tree *v);
     tree* TreeMinimum(tree *x);
-};
\ No newline at end of file
+    int heightnode(tree *x);
+    tree* TreeSuccessor(tree *x);
+    void overlapcollect(tree *x,int low,int high,vector<tree*> &out);
+    void freetree(tree *x);
+    tree* bulkbuild(interval *items,int l,int r,int depth,int reddepth,tree *par);
+};
+#endif
@@ -0,0 +1,490 @@
+#include "Rtree.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+typedef struct rentry{
+    rect r;
+    rnode *c;
+} rentry;
+
+static bool validrect(rect r)
+{
+    return r.x1<=r.x2&&r.y1<=r.y2;
+}
+
+static bool samerect(rect a,rect b)
+{
+    return a.x1==b.x1&&a.y1==b.y1&&a.x2==b.x2&&a.y2==b.y2;
+}
+
+static rect unionrect(rect a,rect b)
+{
+    rect u;
+    u.x1=min(a.x1,b.x1);
+    u.y1=min(a.y1,b.y1);
+    u.x2=max(a.x2,b.x2);
+    u.y2=max(a.y2,b.y2);
+    return u;
+}
+
+//面积可能超出long long，用double计算
+static double area(rect r)
+{
+    return ((double)r.x2-r.x1)*((double)r.y2-r.y1);
+}
+
+static double margin(rect r)
+{
+    return ((double)r.x2-r.x1)+((double)r.y2-r.y1);
+}
+
+static double overlaparea(rect a,rect b)
+{
+    double w=(double)min(a.x2,b.x2)-max(a.x1,b.x1);
+    double h=(double)min(a.y2,b.y2)-max(a.y1,b.y1);
+    return (w>0&&h>0)?w*h:0;
+}
+
+static rect getentry(rnode *x,int i)
+{
+    rect r;
+    r.x1=x->x1[i];
+    r.y1=x->y1[i];
+    r.x2=x->x2[i];
+    r.y2=x->y2[i];
+    return r;
+}
+
+//结点中与q相交的表项，第i位对应第i个表项；空表项是哨兵，不会置位
+static unsigned overlapmask(rnode *x,rect q)
+{
+    unsigned m=0;
+    for(int i=0;i<RMAX;i++)
+        m|=(unsigned)((x->x1[i]<q.x2)&(x->x2[i]>q.x1)&(x->y1[i]<q.y2)&(x->y2[i]>q.y1))<<i;
+    return m;
+}
+
+Rtree::Rtree()
+{
+    root=newnode(0);
+    total=0;
+}
+
+Rtree::~Rtree()
+{
+}
+
+rnode* Rtree::newnode(int level)
+{
+    rnode *x=pool.alloc();
+    for(int i=0;i<RMAX;i++)
+    {
+        x->x1[i]=x->y1[i]=INT_MAX;
+        x->x2[i]=x->y2[i]=INT_MIN;
+        x->child[i]=NULL;
+    }
+    x->p=NULL;
+    x->count=0;
+    x->level=level;
+    return x;
+}
+
+void Rtree::freetree(rnode *x)
+{
+    if(x->level>0)
+        for(int i=0;i<x->count;i++)
+            freetree(x->child[i]);
+    pool.release(x);
+}
+
+void Rtree::setentry(rnode *x,int i,rect r,rnode *c)
+{
+    x->x1[i]=r.x1;
+    x->y1[i]=r.y1;
+    x->x2[i]=r.x2;
+    x->y2[i]=r.y2;
+    x->child[i]=c;
+    if(c!=NULL) c->p=x;
+}
+
+//删除第i个表项：最后一个表项移入空位，原位置恢复为哨兵
+void Rtree::removeentry(rnode *x,int i)
+{
+    int last=--x->count;
+    setentry(x,i,getentry(x,last),x->child[last]);
+    x->x1[last]=x->y1[last]=INT_MAX;
+    x->x2[last]=x->y2[last]=INT_MIN;
+    x->child[last]=NULL;
+}
+
+rect Rtree::cover(rnode *x)
+{
+    rect u=getentry(x,0);
+    for(int i=1;i<x->count;i++)
+        u=unionrect(u,getentry(x,i));
+    return u;
+}
+
+int Rtree::childindex(rnode *x)
+{
+    int i;
+    for(i=0;x->p->child[i]!=x;i++);
+    return i;
+}
+
+//x的表项改变后，沿父指针向上重算外包矩形
+void Rtree::adjustup(rnode *x)
+{
+    for(;x->p!=NULL;x=x->p)
+        setentry(x->p,childindex(x),cover(x),x);
+}
+
+//自根下降到第level层：选外包矩形面积增量最小的孩子，相同时选面积较小的
+rnode* Rtree::choosenode(rect r,int level)
+{
+    rnode *x=root;
+    while(x->level>level)
+    {
+        int best=0;
+        double bestinc=HUGE_VAL,bestarea=HUGE_VAL;
+        for(int i=0;i<x->count;i++)
+        {
+            rect e=getentry(x,i);
+            double a=area(e),inc=area(unionrect(e,r))-a;
+            if(inc<bestinc||(inc==bestinc&&a<bestarea))
+            {
+                best=i;
+                bestinc=inc;
+                bestarea=a;
+            }
+        }
+        x=x->child[best];
+    }
+    return x;
+}
+
+//在第level层插入表项(r,c)，满则分裂并向上传递，根分裂时树长高一层
+void Rtree::insertentry(rect r,rnode *c,int level)
+{
+    rnode *x=choosenode(r,level),*nn;
+    if(x->count<RMAX)
+    {
+        setentry(x,x->count++,r,c);
+        adjustup(x);
+        return;
+    }
+    nn=splitnode(x,r,c);
+    while(x!=root)
+    {
+        rnode *par=x->p;
+        setentry(par,childindex(x),cover(x),x);
+        if(par->count<RMAX)
+        {
+            setentry(par,par->count++,cover(nn),nn);
+            adjustup(par);
+            return;
+        }
+        nn=splitnode(par,cover(nn),nn);
+        x=par;
+    }
+    root=newnode(x->level+1);
+    setentry(root,0,cover(x),x);
+    setentry(root,1,cover(nn),nn);
+    root->count=2;
+}
+
+//R*树分裂：x的RMAX个表项加上(r,c)共RMAX+1个，分别按两维的中点排序，
+//取各种分法外包矩形周长之和较小的一维，再在该维上取两组重叠面积最小（其次面积和最小）的分法。
+//前一组留在x，后一组放入返回的新结点
+rnode* Rtree::splitnode(rnode *x,rect r,rnode *c)
+{
+    rentry e[RMAX+1],best[RMAX+1];
+    int i,k,axis,bestk=RMIN;
+    double bestmargin=HUGE_VAL;
+    for(i=0;i<RMAX;i++)
+    {
+        e[i].r=getentry(x,i);
+        e[i].c=x->child[i];
+    }
+    e[RMAX].r=r;
+    e[RMAX].c=c;
+    for(axis=0;axis<2;axis++)
+    {
+        rentry s[RMAX+1];
+        copy(e,e+RMAX+1,s);
+        if(axis==0)
+            sort(s,s+RMAX+1,[](const rentry &a,const rentry &b){return (long long)a.r.x1+a.r.x2<(long long)b.r.x1+b.r.x2;});
+        else
+            sort(s,s+RMAX+1,[](const rentry &a,const rentry &b){return (long long)a.r.y1+a.r.y2<(long long)b.r.y1+b.r.y2;});
+        rect pre[RMAX+1],suf[RMAX+1];
+        pre[0]=s[0].r;
+        for(i=1;i<=RMAX;i++)
+            pre[i]=unionrect(pre[i-1],s[i].r);
+        suf[RMAX]=s[RMAX].r;
+        for(i=RMAX-1;i>=0;i--)
+            suf[i]=unionrect(suf[i+1],s[i].r);
+        double m=0,bestov=HUGE_VAL,bestar=HUGE_VAL;
+        int kk=RMIN;
+        for(k=RMIN;k<=RMAX+1-RMIN;k++)                  //前k个为一组
+        {
+            m+=margin(pre[k-1])+margin(suf[k]);
+            double ov=overlaparea(pre[k-1],suf[k]),ar=area(pre[k-1])+area(suf[k]);
+            if(ov<bestov||(ov==bestov&&ar<bestar))
+            {
+                kk=k;
+                bestov=ov;
+                bestar=ar;
+            }
+        }
+        if(m<bestmargin)
+        {
+            bestmargin=m;
+            bestk=kk;
+            copy(s,s+RMAX+1,best);
+        }
+    }
+    rnode *nn=newnode(x->level);
+    for(i=0;i<RMAX;i++)
+    {
+        x->x1[i]=x->y1[i]=INT_MAX;
+        x->x2[i]=x->y2[i]=INT_MIN;
+        x->child[i]=NULL;
+    }
+    for(i=0;i<bestk;i++)
+        setentry(x,i,best[i].r,best[i].c);
+    x->count=bestk;
+    for(i=bestk;i<=RMAX;i++)
+        setentry(nn,i-bestk,best[i].r,best[i].c);
+    nn->count=RMAX+1-bestk;
+    return nn;
+}
+
+//插入矩形，与已有矩形完全相同或坐标不合法时返回false
+bool Rtree::Rinsert(rect r)
+{
+    int slot;
+    if(!validrect(r)||findleaf(root,r,slot)!=NULL) return false;
+    insertentry(r,NULL,0);
+    total++;
+    return true;
+}
+
+//在x的子树中找到与r完全相同的叶表项，只进入外包矩形包含r的孩子
+rnode* Rtree::findleaf(rnode *x,rect r,int &slot)
+{
+    int i;
+    if(x->level==0)
+    {
+        for(i=0;i<x->count;i++)
+            if(samerect(getentry(x,i),r))
+            {
+                slot=i;
+                return x;
+            }
+        return NULL;
+    }
+    for(i=0;i<x->count;i++)
+        if(x->x1[i]<=r.x1&&x->y1[i]<=r.y1&&x->x2[i]>=r.x2&&x->y2[i]>=r.y2)
+        {
+            rnode *leaf=findleaf(x->child[i],r,slot);
+            if(leaf!=NULL) return leaf;
+        }
+    return NULL;
+}
+
+//自叶结点x向上：不足RMIN个表项的非根结点从父结点摘下，其余结点重算外包矩形；
+//摘下结点的表项重新插入原层，原层不低于根时（树已变矮）拆到叶子逐个插入
+void Rtree::condense(rnode *x)
+{
+    vector<rnode*> orphan;
+    size_t i;
+    int j;
+    while(x!=root)
+    {
+        rnode *par=x->p;
+        int k=childindex(x);
+        if(x->count<RMIN)
+        {
+            removeentry(par,k);
+            orphan.push_back(x);
+        }
+        else setentry(par,k,cover(x),x);
+        x=par;
+    }
+    while(root->level>0&&root->count==1)                //根只剩一个孩子时去掉根
+    {
+        x=root;
+        root=root->child[0];
+        root->p=NULL;
+        pool.release(x);
+    }
+    if(root->level>0&&root->count==0)
+    {
+        pool.release(root);
+        root=newnode(0);
+    }
+    for(i=0;i<orphan.size();i++)
+    {
+        x=orphan[i];
+        if(x->level<root->level)
+            for(j=0;j<x->count;j++)
+                insertentry(getentry(x,j),x->child[j],x->level);
+        else
+        {
+            vector<rect> rs;
+            leafrects(x,rs);
+            for(size_t t=0;t<rs.size();t++)
+                insertentry(rs[t],NULL,0);
+            if(x->level>0)
+                for(j=0;j<x->count;j++)
+                    freetree(x->child[j]);
+        }
+        pool.release(x);
+    }
+    while(root->level>0&&root->count==1)
+    {
+        x=root;
+        root=root->child[0];
+        root->p=NULL;
+        pool.release(x);
+    }
+}
+
+//删除与r完全相同的矩形，不存在时返回false
+bool Rtree::RDelete(rect r)
+{
+    int slot;
+    rnode *leaf=findleaf(root,r,slot);
+    if(leaf==NULL) return false;
+    removeentry(leaf,slot);
+    condense(leaf);
+    total--;
+    return true;
+}
+
+//STR打包：items去重后自底向上逐层打包，每层按x中点排序切成sqrt(结点数)条，条内按y中点排序后每RMAX个成一个结点。
+//有不合法的矩形时返回false，原树不变
+bool Rtree::Rbulkload(rect *items,int n)
+{
+    int i,level;
+    if(n<0) return false;
+    for(i=0;i<n;i++)
+        if(!validrect(items[i])) return false;
+    vector<rentry> cur(n),next;
+    for(i=0;i<n;i++)
+    {
+        cur[i].r=items[i];
+        cur[i].c=NULL;
+    }
+    sort(cur.begin(),cur.end(),[](const rentry &a,const rentry &b){
+        if(a.r.x1!=b.r.x1) return a.r.x1<b.r.x1;
+        if(a.r.y1!=b.r.y1) return a.r.y1<b.r.y1;
+        if(a.r.x2!=b.r.x2) return a.r.x2<b.r.x2;
+        return a.r.y2<b.r.y2;
+    });
+    cur.erase(unique(cur.begin(),cur.end(),[](const rentry &a,const rentry &b){return samerect(a.r,b.r);}),cur.end());
+    freetree(root);
+    total=cur.size();
+    for(level=0;;level++)
+    {
+        size_t m=cur.size(),nodes=(m+RMAX-1)/RMAX,slices,per,s,t;
+        if(m<=RMAX)
+        {
+            root=newnode(level);
+            for(t=0;t<m;t++)
+                setentry(root,t,cur[t].r,cur[t].c);
+            root->count=m;
+            return true;
+        }
+        slices=(size_t)ceil(sqrt((double)nodes));
+        per=((nodes+slices-1)/slices)*RMAX;             //每条的表项数
+        sort(cur.begin(),cur.end(),[](const rentry &a,const rentry &b){return (long long)a.r.x1+a.r.x2<(long long)b.r.x1+b.r.x2;});
+        for(s=0;s<m;s+=per)
+            sort(cur.begin()+s,cur.begin()+min(s+per,m),[](const rentry &a,const rentry &b){return (long long)a.r.y1+a.r.y2<(long long)b.r.y1+b.r.y2;});
+        next.clear();
+        for(s=0;s<m;s+=per)
+        {
+            size_t e=min(s+per,m);
+            for(t=s;t<e;t+=RMAX)                        //条内每RMAX个装一个结点，不跨条
+            {
+                rnode *x=newnode(level);
+                size_t k;
+                for(k=t;k<e&&k<t+RMAX;k++)
+                    setentry(x,k-t,cur[k].r,cur[k].c);
+                x->count=k-t;
+                rentry up;
+                up.r=cover(x);
+                up.c=x;
+                next.push_back(up);
+            }
+        }
+        cur.swap(next);
+    }
+}
+
+//找出与q相交的任一矩形
+bool Rtree::RSearch(rect q,rect &out)
+{
+    vector<rnode*> stack;
+    stack.push_back(root);
+    while(!stack.empty())
+    {
+        rnode *x=stack.back();
+        stack.pop_back();
+        unsigned m=overlapmask(x,q);
+        if(m==0) continue;
+        if(x->level==0)
+        {
+            out=getentry(x,__builtin_ctz(m));
+            return true;
+        }
+        for(;m!=0;m&=m-1)
+            stack.push_back(x->child[__builtin_ctz(m)]);
+    }
+    return false;
+}
+
+void Rtree::collect(rnode *x,rect q,vector<rect> &out)
+{
+    unsigned m=overlapmask(x,q);
+    for(;m!=0;m&=m-1)
+    {
+        int i=__builtin_ctz(m);
+        if(x->level==0) out.push_back(getentry(x,i));
+        else collect(x->child[i],q,out);
+    }
+}
+
+//找出与q相交的全部矩形，追加到out，返回个数
+int Rtree::RSearchAll(rect q,vector<rect> &out)
+{
+    size_t old=out.size();
+    collect(root,q,out);
+    return out.size()-old;
+}
+
+void Rtree::leafrects(rnode *x,vector<rect> &out)
+{
+    for(int i=0;i<x->count;i++)
+        if(x->level==0) out.push_back(getentry(x,i));
+        else leafrects(x->child[i],out);
+}
+
+//导出全部矩形，追加到out，返回个数
+int Rtree::Rrects(vector<rect> &out)
+{
+    size_t old=out.size();
+    leafrects(root,out);
+    return out.size()-old;
+}
+
+int Rtree::height()
+{
+    return root->level+1;
+}
+
+int Rtree::gettotal()
+{
+    return total;
+}
@@ -0,0 +1,62 @@
+#ifndef RTREE_H
+#define RTREE_H
+#include <cstddef>
+#include <vector>
+#include "Nodepool.h"
+#define RMAX 16                                         //结点扇出：每个坐标数组16个int，恰为一个64字节缓存行
+#define RMIN 6                                          //非根结点至少RMAX*40%个表项
+using namespace std;
+
+//二维矩形[x1,x2]x[y1,y2]，两维都按INTtree的规则判断相交：x1<q.x2且x2>q.x1，y同理
+typedef struct rect{
+    int x1,y1;
+    int x2,y2;
+} rect;
+
+//R树结点：表项的四个坐标分开存放（SoA），查询时一个结点只读四个缓存行，比较可被编译器向量化；
+//空表项填入永不相交的哨兵矩形，比较循环固定RMAX次。叶结点（level=0）表项即矩形本身，内部结点表项为孩子的外包矩形
+typedef struct alignas(64) rnode{
+    int x1[RMAX],y1[RMAX];
+    int x2[RMAX],y2[RMAX];
+    rnode *child[RMAX];
+    rnode *p;
+    int count;
+    int level;
+} rnode;
+
+//二维区间索引，接口与INTtree对应：插入、删除、查找一个相交矩形、找出全部相交矩形。
+//插入沿面积增量最小的孩子下降，满结点按R*树的方法分裂；删除后不足RMIN的结点摘下，表项重新插入原层；
+//Rbulkload用STR（Sort-Tile-Recursive）打包，按x切成约sqrt(n/RMAX)条，条内按y排序后每RMAX个装满一个结点。
+//相交查询只进入外包矩形与查询相交的孩子，打包良好时访问结点数接近O(log n+k/RMAX)
+class Rtree{
+public:
+    Rtree();
+    ~Rtree();
+    bool Rinsert(rect r);
+    bool RDelete(rect r);
+    bool Rbulkload(rect *items,int n);
+    bool RSearch(rect q,rect &out);
+    int RSearchAll(rect q,vector<rect> &out);
+    int Rrects(vector<rect> &out);
+    int height();
+    int gettotal();
+private:
+    rnode *root;
+    int total;
+    Nodepool<rnode> pool;                               //结点池，结点成块分配并复用已删除结点
+    rnode *newnode(int level);
+    void freetree(rnode *x);
+    void setentry(rnode *x,int i,rect r,rnode *c);
+    void removeentry(rnode *x,int i);
+    rect cover(rnode *x);
+    int childindex(rnode *x);
+    void adjustup(rnode *x);
+    rnode *choosenode(rect r,int level);
+    void insertentry(rect r,rnode *c,int level);
+    rnode *splitnode(rnode *x,rect r,rnode *c);
+    rnode *findleaf(rnode *x,rect r,int &slot);
+    void condense(rnode *x);
+    void collect(rnode *x,rect q,vector<rect> &out);
+    void leafrects(rnode *x,vector<rect> &out);
+};
+#endif
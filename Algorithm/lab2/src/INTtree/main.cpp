@@ -1,8 +1,11 @@
-#include"INTtree.h"
+#include"INTindex.h"
+#include"Rtree.h"
 
 int main()
 {
     INTtree *intree; 
+    Rtree rtree;                                        //二维矩形索引，与区间树相互独立
+    rect r;
     int k=1;
     int mode,low,high;
     intree=new INTtree();
@@ -17,6 +20,12 @@ int main()
         printf("No.2:Delete a node.\n");
         printf("No.3:Search an interval in INTtree.\n");
         printf("No.4:Draw the INTtree.\n");
+        printf("No.5:Search all intervals overlapping an interval.\n");
+        printf("No.6:Freeze the INTtree and search an interval in the index.\n");
+        printf("No.7:Export the INTtree to tree.dot and tree.json.\n");
+        printf("No.8:Insert a rectangle into the 2-D index.\n");
+        printf("No.9:Delete a rectangle from the 2-D index.\n");
+        printf("No.10:Search all rectangles overlapping a rectangle.\n");
         scanf("%d",&mode);
         switch(mode)
         {
@@ -39,7 +48,7 @@ int main()
                 scanf("%d%d",&low,&high);
                 tree *x;
                 if((x=intree->INTSearch(low,high))!=NULL) 
-                    printf("The cover interval is [%d,%d].\n",x->inter->low,x->inter->high);
+                    printf("The cover interval is [%d,%d].\n",x->inter.low,x->inter.high);
                 else printf("Can't find it!\n");
                 break;
             }
@@ -47,6 +56,56 @@ int main()
                 intree->printtree();
                 exit(0);
             }
+            case 5:{
+                printf("Input the interval:\n");
+                scanf("%d%d",&low,&high);
+                vector<tree*> all;
+                intree->INTSearchAll(low,high,all);
+                for(size_t i=0;i<all.size();i++)
+                    printf("[%d,%d] ",all[i]->inter.low,all[i]->inter.high);
+                printf("\n%d intervals found.\n",(int)all.size());
+                break;
+            }
+            case 6:{
+                printf("Input the interval:\n");
+                scanf("%d%d",&low,&high);
+                INTindex index(*intree);
+                int i=index.search(low,high);
+                if(i>=0)
+                    printf("The cover interval is [%d,%d].\n",index.get(i).low,index.get(i).high);
+                else printf("Can't find it!\n");
+                break;
+            }
+            case 7:{
+                if(intree->exportdot("tree.dot")&&intree->exportjson("tree.json"))
+                    printf("Exported to tree.dot and tree.json.\n");
+                else printf("Error:Can't write the files!\n");
+                break;
+            }
+            case 8:{
+                printf("Input the rectangle x1 y1 x2 y2:\n");
+                scanf("%d%d%d%d",&r.x1,&r.y1,&r.x2,&r.y2);
+                if(!rtree.Rinsert(r))
+                    printf("Error:This rectangle exsits or is invalid!\n");
+                break;
+            }
+            case 9:{
+                printf("Input the rectangle x1 y1 x2 y2:\n");
+                scanf("%d%d%d%d",&r.x1,&r.y1,&r.x2,&r.y2);
+                if(!rtree.RDelete(r))
+                    printf("Error:This rectangle does not exsit!\n");
+                break;
+            }
+            case 10:{
+                printf("Input the rectangle x1 y1 x2 y2:\n");
+                scanf("%d%d%d%d",&r.x1,&r.y1,&r.x2,&r.y2);
+                vector<rect> all;
+                rtree.RSearchAll(r,all);
+                for(size_t i=0;i<all.size();i++)
+                    printf("[%d,%d]x[%d,%d] ",all[i].x1,all[i].x2,all[i].y1,all[i].y2);
+                printf("\n%d rectangles found.\n",(int)all.size());
+                break;
+            }
             default:{
                 break;
             }
@@ -0,0 +1,75 @@
+#ifndef LEFTRIGHT_H
+#define LEFTRIGHT_H
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+//一写多读的并发外壳（Left-Right）：保存两份相同的树，读者只读其中一份，写者先改另一份，
+//切换读者所用的一份后等旧读者全部离开（类似RCU的宽限期），再对旧的一份重放同一操作。
+//读者不加锁、不等待，总是看到某次写操作完成前或完成后的完整状态；写者仍调用树原有的插入/删除/旋转/修复代码，
+//写操作须是确定性的，两次执行结果一致。读者计数按线程分散到不同缓存行，读吞吐量随核数增长
+template<typename T>
+class Leftright
+{
+public:
+    Leftright()
+    {
+        front.store(0);
+        version.store(0);
+        for(int i=0;i<2;i++)
+            for(int j=0;j<SLOTS;j++)
+                readers[i][j].n.store(0);
+    }
+    //f(T&)只能调用查询操作，返回值原样带回
+    template<typename F>
+    auto read(F f) -> decltype(f(*(T*)0))
+    {
+        Counter &c=readers[version.load()][slot()];
+        c.n.fetch_add(1);
+        struct Leave
+        {
+            Counter &c;
+            ~Leave(){c.n.fetch_sub(1);}
+        } leave={c};
+        return f(inst[front.load()]);
+    }
+    //f(T&)对两份树各执行一次，返回第一次的结果（不能为void）
+    template<typename F>
+    auto write(F f) -> decltype(f(*(T*)0))
+    {
+        std::lock_guard<std::mutex> guard(wlock);
+        int back=1-front.load();
+        auto result=f(inst[back]);
+        front.store(back);
+        int prev=version.load();
+        drain(1-prev);
+        version.store(1-prev);
+        drain(prev);
+        f(inst[1-back]);
+        return result;
+    }
+private:
+    enum{SLOTS=64};
+    struct Counter
+    {
+        alignas(64) std::atomic<long> n;
+    };
+    T inst[2];
+    std::atomic<int> front;                             //读者当前使用的一份
+    std::atomic<int> version;                           //新读者登记在哪一组计数上
+    Counter readers[2][SLOTS];
+    std::mutex wlock;
+    static int slot()
+    {
+        static std::atomic<int> next(0);
+        thread_local int s=next.fetch_add(1)%SLOTS;
+        return s;
+    }
+    void drain(int v)
+    {
+        for(int j=0;j<SLOTS;j++)
+            while(readers[v][j].n.load()!=0)
+                std::this_thread::yield();
+    }
+};
+#endif
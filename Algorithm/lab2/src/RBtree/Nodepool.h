@@ -0,0 +1,59 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+#include <vector>
+
+//结点池：结点按块（slab）成批申请，同一棵树的结点在内存中连续；
+//删除的结点放入空闲表，下次分配优先复用，避免逐个new/delete
+template<typename T>
+class Nodepool
+{
+public:
+    Nodepool(int slabsize=4096)
+    {
+        this->slabsize=slabsize;
+        used=slabsize;
+    }
+    ~Nodepool()
+    {
+        for(size_t i=0;i<slabs.size();i++)
+            delete []slabs[i];
+    }
+    T *alloc()
+    {
+        if(!freed.empty())
+        {
+            T *node=freed.back();
+            freed.pop_back();
+            return node;
+        }
+        if(used==slabsize)                              //当前块用完时申请新块
+        {
+            slabs.push_back(new T[slabsize]);
+            used=0;
+        }
+        return &slabs.back()[used++];
+    }
+    void release(T *node)
+    {
+        freed.push_back(node);
+    }
+    //接管other的全部结点：两棵树合并后结点归本池所有，other变为空池
+    void absorb(Nodepool &other)
+    {
+        slabs.insert(slabs.begin(),other.slabs.begin(),other.slabs.end());
+        freed.insert(freed.end(),other.freed.begin(),other.freed.end());
+        if(!other.slabs.empty())                        //other当前块未用的部分并入空闲表
+            for(int i=other.used;i<other.slabsize;i++)
+                freed.push_back(&other.slabs.back()[i]);
+        other.slabs.clear();
+        other.freed.clear();
+        other.used=other.slabsize;
+    }
+private:
+    std::vector<T*> slabs;
+    std::vector<T*> freed;
+    int slabsize,used;
+    Nodepool(const Nodepool&);
+    Nodepool &operator=(const Nodepool&);
+};
+#endif
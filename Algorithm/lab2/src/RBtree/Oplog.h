@@ -0,0 +1,141 @@
+#ifndef OPLOG_H
+#define OPLOG_H
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+//操作日志：每条操作为(op,a,b)，op取下列字符之一
+//i插入、d删除、s查找、o范围/重叠查询；RBtree只用a作关键字（o查询[a,b]内的关键字个数），
+//INTtree以[a,b]为区间（s为包含a的区间，o为与(a,b)重叠的全部区间）
+//文本格式每行一条，如"i 3 9"；二进制格式为"TOL1"文件头+8字节条数+每条3个int
+typedef struct oprec{
+    int op;
+    int a;
+    int b;
+} oprec;
+
+static bool readoplog(const char *file,std::vector<oprec> &ops)
+{
+    FILE *in=fopen(file,"rb");
+    char magic[4];
+    long long n;
+    if(in==NULL) return false;
+    if(fread(magic,1,4,in)==4&&memcmp(magic,"TOL1",4)==0)
+    {
+        bool ok=fread(&n,sizeof(n),1,in)==1&&n>=0;
+        if(ok)
+        {
+            ops.resize(n);
+            ok=fread(ops.data(),sizeof(oprec),n,in)==(size_t)n;
+        }
+        fclose(in);
+        return ok;
+    }
+    rewind(in);
+    char op[2];
+    oprec r;
+    ops.clear();
+    while(fscanf(in,"%1s%d%d",op,&r.a,&r.b)==3)
+    {
+        r.op=op[0];
+        ops.push_back(r);
+    }
+    fclose(in);
+    return true;
+}
+
+static bool writeoplog(const char *file,std::vector<oprec> &ops,bool binary)
+{
+    FILE *out=fopen(file,"wb");
+    size_t i;
+    if(out==NULL) return false;
+    if(binary)
+    {
+        long long n=ops.size();
+        fwrite("TOL1",1,4,out);
+        fwrite(&n,sizeof(n),1,out);
+        fwrite(ops.data(),sizeof(oprec),n,out);
+    }
+    else
+        for(i=0;i<ops.size();i++)
+            fprintf(out,"%c %d %d\n",ops[i].op,ops[i].a,ops[i].b);
+    return fclose(out)==0;
+}
+
+//区间右端点由左端点确定，删除时才能给出与插入时相同的区间
+static int ophigh(int a,int maxlen)
+{
+    unsigned h=(unsigned)a*2654435761u;
+    return a+1+(int)((h>>8)%(unsigned)maxlen);
+}
+
+//Zipf分布（参数s）的名次采样：预先算出累积分布，二分查找；名次经乘法散列打散到整个关键字空间
+class Zipfgen
+{
+public:
+    Zipfgen(int keys,double s)
+    {
+        double sum=0;
+        cdf.resize(keys);
+        for(int i=0;i<keys;i++)
+        {
+            sum+=1.0/pow(i+1.0,s);
+            cdf[i]=sum;
+        }
+        for(int i=0;i<keys;i++)
+            cdf[i]/=sum;
+        n=keys;
+    }
+    template<typename G>
+    int operator()(G &gen)
+    {
+        double u=std::uniform_real_distribution<double>(0,1)(gen);
+        int r=std::lower_bound(cdf.begin(),cdf.end(),u)-cdf.begin();
+        if(r>=n) r=n-1;
+        return (int)(((unsigned long long)r*2654435761ull)%(unsigned long long)n);
+    }
+private:
+    std::vector<double> cdf;
+    int n;
+};
+
+//生成m条操作：dist为uniform、sequential或zipf，关键字取自[0,keys)，
+//mix为插入、删除、查找、重叠查询的百分比；sequential时插入按递增顺序，其余操作均匀地针对已插入的关键字
+static bool genoplog(const char *dist,long long m,int keys,const int mix[4],int maxlen,std::vector<oprec> &ops)
+{
+    std::mt19937_64 gen(2334+m);
+    std::uniform_int_distribution<int> ukey(0,keys-1);
+    std::uniform_int_distribution<int> pct(0,99);
+    Zipfgen *zipf=NULL;
+    int d,next=0;
+    if(strcmp(dist,"uniform")==0) d=0;
+    else if(strcmp(dist,"sequential")==0) d=1;
+    else if(strcmp(dist,"zipf")==0)
+    {
+        d=2;
+        zipf=new Zipfgen(keys,0.99);
+    }
+    else return false;
+    ops.resize(m);
+    for(long long i=0;i<m;i++)
+    {
+        int p=pct(gen),op,a;
+        if(p<mix[0]) op='i';
+        else if(p<mix[0]+mix[1]) op='d';
+        else if(p<mix[0]+mix[1]+mix[2]) op='s';
+        else op='o';
+        if(d==0) a=ukey(gen);
+        else if(d==2) a=(*zipf)(gen);
+        else if(op=='i') a=next++;
+        else a=next>0?(int)(gen()%next):0;
+        ops[i].op=op;
+        ops[i].a=a;
+        ops[i].b=(op=='o')?a+1+(int)(gen()%maxlen):ophigh(a,maxlen);
+    }
+    delete zipf;
+    return true;
+}
+#endif
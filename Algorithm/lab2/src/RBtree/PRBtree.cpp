@@ -0,0 +1,352 @@
+#include "PRBtree.h"
+
+PRBtree::PRBtree()
+{
+    nil=new pnode;
+    nil->data=0;
+    nil->col=black;
+    nil->ref=0;
+    nil->stamp=0;
+    nil->left=NULL;
+    nil->right=NULL;
+    op=0;
+    addversion(nil,0);                                  //版本0为空树
+}
+
+PRBtree::~PRBtree()
+{
+    delete nil;
+}
+
+pnode* PRBtree::newnode(int num)
+{
+    pnode *x=pool.alloc();
+    x->data=num;
+    x->col=red;
+    x->ref=1;
+    x->stamp=op;
+    x->left=nil;
+    x->right=nil;
+    return x;
+}
+
+//取得slot所指结点的可写副本：本次操作新建的结点直接返回，否则复制一份挂到slot上，
+//副本与原结点共享左右子树
+pnode* PRBtree::own(pnode *&slot)
+{
+    pnode *x=slot;
+    if(x->stamp==op) return x;
+    pnode *y=pool.alloc();
+    *y=*x;
+    y->ref=1;
+    y->stamp=op;
+    if(y->left!=nil) y->left->ref++;
+    if(y->right!=nil) y->right->ref++;
+    slot=y;
+    unref(x);
+    return y;
+}
+
+void PRBtree::unref(pnode *x)
+{
+    if(x==nil) return;
+    if(--x->ref==0)
+    {
+        unref(x->left);
+        unref(x->right);
+        pool.release(x);
+    }
+}
+
+//旋转只改指针，slot及其相关孩子须已是可写副本
+void PRBtree::leftrotate(pnode *&slot)
+{
+    pnode *x=slot,*y=x->right;
+    x->right=y->left;
+    y->left=x;
+    slot=y;
+}
+
+void PRBtree::rightrotate(pnode *&slot)
+{
+    pnode *x=slot,*y=x->left;
+    x->left=y->right;
+    y->right=x;
+    slot=y;
+}
+
+//path[i]在树中的位置：父结点的左/右指针，i==0时为根
+pnode*& PRBtree::slotof(vector<pnode*> &path,int i,pnode *&root)
+{
+    if(i==0) return root;
+    if(path[i-1]->left==path[i]) return path[i-1]->left;
+    return path[i-1]->right;
+}
+
+int PRBtree::addversion(pnode *root,int count)
+{
+    roots.push_back(root);
+    counts.push_back(count);
+    return roots.size()-1;
+}
+
+//在版本v上插入num，返回新版本号；v无效或num已存在时返回-1
+int PRBtree::PRBinsert(int v,int num)
+{
+    if(v<0||v>=(int)roots.size()||roots[v]==NULL) return -1;
+    op++;
+    pnode *root=roots[v];
+    if(root==nil)
+    {
+        root=newnode(num);
+        root->col=black;
+        return addversion(root,1);
+    }
+    root->ref++;
+    vector<pnode*> path;
+    pnode *x=own(root);
+    while(1)
+    {
+        path.push_back(x);
+        if(x->data==num)
+        {
+            unref(root);                                //丢弃本次复制的路径
+            return -1;
+        }
+        pnode *&c=(num<x->data)?x->left:x->right;
+        if(c==nil)
+        {
+            c=newnode(num);
+            insertfix(path,c,root);
+            break;
+        }
+        x=own(c);
+    }
+    root->col=black;
+    return addversion(root,counts[v]+1);
+}
+
+//path为z的祖先（均已复制），分情况同RBtree::insertfixcolor，叔结点变色前先复制
+void PRBtree::insertfix(vector<pnode*> &path,pnode *z,pnode *&root)
+{
+    int i=path.size()-1;
+    while(i>=1&&path[i]->col==red)
+    {
+        pnode *p=path[i],*g=path[i-1];
+        if(p==g->left)
+        {
+            if(g->right->col==red)
+            {
+                p->col=black;
+                own(g->right)->col=black;
+                g->col=red;
+                z=g;
+                i-=2;
+                continue;
+            }
+            if(z==p->right)
+            {
+                leftrotate(g->left);
+                z=p;
+                p=g->left;
+            }
+            p->col=black;
+            g->col=red;
+            rightrotate(slotof(path,i-1,root));
+        }
+        else
+        {
+            if(g->left->col==red)
+            {
+                p->col=black;
+                own(g->left)->col=black;
+                g->col=red;
+                z=g;
+                i-=2;
+                continue;
+            }
+            if(z==p->left)
+            {
+                rightrotate(g->right);
+                z=p;
+                p=g->right;
+            }
+            p->col=black;
+            g->col=red;
+            leftrotate(slotof(path,i-1,root));
+        }
+        break;
+    }
+}
+
+//在版本v上删除num，返回新版本号；v无效或num不存在时返回-1
+int PRBtree::PRBDelete(int v,int num)
+{
+    if(!PRBSearch(v,num)) return -1;
+    op++;
+    pnode *root=roots[v];
+    root->ref++;
+    vector<pnode*> path;
+    pnode *z=own(root);
+    while(z->data!=num)
+    {
+        path.push_back(z);
+        z=own((num<z->data)?z->left:z->right);
+    }
+    if(z->left!=nil&&z->right!=nil)                     //有两个孩子时用后继的关键字替换，改删后继
+    {
+        path.push_back(z);
+        pnode *y=own(z->right);
+        while(y->left!=nil)
+        {
+            path.push_back(y);
+            y=own(y->left);
+        }
+        z->data=y->data;
+        z=y;
+    }
+    pnode *x=(z->left!=nil)?z->left:z->right;
+    bool xleft=!path.empty()&&path.back()->left==z;
+    if(path.empty()) root=x;
+    else if(xleft) path.back()->left=x;
+    else path.back()->right=x;
+    color zcol=z->col;
+    pool.release(z);                                    //z是本次新建的副本，孩子已移交给父结点
+    if(zcol==black)
+        deletefix(path,x,xleft,root);
+    return addversion(root,counts[v]-1);
+}
+
+//path为x的祖先（均已复制），xleft表示x是否为左孩子；分情况同RBtree::RBnodeDeleteFixup，
+//兄弟结点及其将变色的孩子先复制
+void PRBtree::deletefix(vector<pnode*> &path,pnode *x,bool xleft,pnode *&root)
+{
+    while(!path.empty()&&x->col==black)
+    {
+        pnode *p=path.back(),*w;
+        int i=path.size()-1;
+        if(xleft)
+        {
+            w=own(p->right);
+            if(w->col==red)
+            {
+                w->col=black;
+                p->col=red;
+                leftrotate(slotof(path,i,root));
+                path.back()=w;
+                path.push_back(p);
+                w=own(p->right);
+            }
+            if(w->left->col==black&&w->right->col==black)
+            {
+                w->col=red;
+                x=p;
+                path.pop_back();
+                if(!path.empty()) xleft=(path.back()->left==x);
+                continue;
+            }
+            if(w->right->col==black)
+            {
+                own(w->left)->col=black;
+                w->col=red;
+                rightrotate(p->right);
+                w=p->right;
+            }
+            w->col=p->col;
+            p->col=black;
+            own(w->right)->col=black;
+            leftrotate(slotof(path,path.size()-1,root));
+        }
+        else
+        {
+            w=own(p->left);
+            if(w->col==red)
+            {
+                w->col=black;
+                p->col=red;
+                rightrotate(slotof(path,i,root));
+                path.back()=w;
+                path.push_back(p);
+                w=own(p->left);
+            }
+            if(w->left->col==black&&w->right->col==black)
+            {
+                w->col=red;
+                x=p;
+                path.pop_back();
+                if(!path.empty()) xleft=(path.back()->left==x);
+                continue;
+            }
+            if(w->left->col==black)
+            {
+                own(w->right)->col=black;
+                w->col=red;
+                leftrotate(p->left);
+                w=p->left;
+            }
+            w->col=p->col;
+            p->col=black;
+            own(w->left)->col=black;
+            rightrotate(slotof(path,path.size()-1,root));
+        }
+        x=root;
+        path.clear();
+    }
+    if(x->col==red)
+    {
+        if(path.empty()) own(root)->col=black;
+        else if(xleft) own(path.back()->left)->col=black;
+        else own(path.back()->right)->col=black;
+    }
+}
+
+bool PRBtree::PRBSearch(int v,int num)
+{
+    if(v<0||v>=(int)roots.size()||roots[v]==NULL) return false;
+    pnode *x=roots[v];
+    while(x!=nil&&x->data!=num)
+        x=(num<x->data)?x->left:x->right;
+    return x!=nil;
+}
+
+//为版本v另建一个版本号，O(1)，两者可分别释放
+int PRBtree::snapshot(int v)
+{
+    if(v<0||v>=(int)roots.size()||roots[v]==NULL) return -1;
+    if(roots[v]!=nil) roots[v]->ref++;
+    return addversion(roots[v],counts[v]);
+}
+
+int PRBtree::latest()
+{
+    return roots.size()-1;
+}
+
+int PRBtree::size(int v)
+{
+    if(v<0||v>=(int)roots.size()||roots[v]==NULL) return -1;
+    return counts[v];
+}
+
+//释放版本v，只被它引用的结点回收
+void PRBtree::release(int v)
+{
+    if(v<0||v>=(int)roots.size()||roots[v]==NULL) return;
+    unref(roots[v]);
+    roots[v]=NULL;
+}
+
+void PRBtree::inordernode(pnode *x,vector<int> &out)
+{
+    if(x==nil) return;
+    inordernode(x->left,out);
+    out.push_back(x->data);
+    inordernode(x->right,out);
+}
+
+//按升序输出版本v的全部关键字
+void PRBtree::inorder(int v,vector<int> &out)
+{
+    if(v<0||v>=(int)roots.size()||roots[v]==NULL) return;
+    inordernode(roots[v],out);
+}
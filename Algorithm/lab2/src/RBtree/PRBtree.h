@@ -0,0 +1,46 @@
+#ifndef PRBTREE_H
+#define PRBTREE_H
+#include <vector>
+#include "RBtree.h"
+
+typedef struct pnode{
+    int data;
+    color col;
+    int ref;                                            //引用计数：指向该结点的父结点与版本根个数
+    int stamp;                                          //创建该结点的操作号，等于当前操作号时可直接修改
+    pnode *left,*right;
+} pnode;
+
+//持久化红黑树：每次插入/删除只复制根到目标的路径以及修复时改动的兄弟结点，其余子树与旧版本共享，
+//返回新版本号，旧版本保持不变仍可查询。结点没有父指针，修复时用路径栈代替，旋转与修复分情况同RBtree。
+//版本用release释放后，不再被任何版本引用的结点回收到结点池
+class PRBtree{
+public:
+    PRBtree();
+    ~PRBtree();
+    int PRBinsert(int v,int num);
+    int PRBDelete(int v,int num);
+    bool PRBSearch(int v,int num);
+    int snapshot(int v);
+    int latest();
+    int size(int v);
+    void release(int v);
+    void inorder(int v,vector<int> &out);
+private:
+    pnode *nil;
+    int op;
+    vector<pnode*> roots;                               //roots[v]为版本v的根，已释放的版本为NULL
+    vector<int> counts;
+    Nodepool<pnode> pool;
+    pnode *newnode(int num);
+    pnode *own(pnode *&slot);
+    void unref(pnode *x);
+    void leftrotate(pnode *&slot);
+    void rightrotate(pnode *&slot);
+    pnode *&slotof(vector<pnode*> &path,int i,pnode *&root);
+    void insertfix(vector<pnode*> &path,pnode *z,pnode *&root);
+    void deletefix(vector<pnode*> &path,pnode *x,bool xleft,pnode *&root);
+    int addversion(pnode *root,int count);
+    void inordernode(pnode *x,vector<int> &out);
+};
+#endif
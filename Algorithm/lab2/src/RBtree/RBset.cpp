@@ -0,0 +1,351 @@
+#include "RBtree.h"
+#include <algorithm>
+#define RBCUTOFF 4096                                   //两棵子树结点数之和小于此值时不再拆分任务
+
+//基于join/split的集合运算。join(l,k,r)要求l中关键字<k<r中关键字，沿较高一棵的右（左）脊下降到黑高相等处挂接，
+//再向上做一次旋转变色，O(|黑高差|+1)；split按关键字把树拆成两棵。并、交、差以较小树的根拆分较大树，
+//左右两半递归互不相交，用OpenMP任务并行，总工作量O(m log(n/m+1))。
+//函数中bh表示子树根到叶子路径上的黑结点数（含根），拆开结点时孩子的黑高由父结点推出，不再沿树重新计算。
+//结点全部复用，不新建结点；运算结束后另一棵树的结点池并入本树，被舍弃的结点回收
+
+int RBtree::blackheight(tree *t)
+{
+    int h=0;
+    for(;t!=nil;t=t->left)
+        if(t->col==black) h++;
+    return h;
+}
+
+tree* RBtree::joinnode(tree *l,tree *k,tree *r,color c)
+{
+    k->left=l;
+    k->right=r;
+    k->col=c;
+    if(l!=nil) l->p=k;
+    if(r!=nil) r->p=k;
+    set_size(k);
+    return k;
+}
+
+//只在子树内旋转，返回新的子树根，根的父指针由调用者设置
+tree* RBtree::rotl(tree *x)
+{
+    tree *y=x->right;
+    x->right=y->left;
+    if(y->left!=nil) y->left->p=x;
+    y->left=x;
+    x->p=y;
+    set_size(x);
+    set_size(y);
+    return y;
+}
+
+tree* RBtree::rotr(tree *x)
+{
+    tree *y=x->left;
+    x->left=y->right;
+    if(y->right!=nil) y->right->p=x;
+    y->right=x;
+    x->p=y;
+    set_size(x);
+    set_size(y);
+    return y;
+}
+
+//bl>=br：沿l的右脊找到黑高为br的黑结点，以红色的k连接它与r；返回子树的黑高仍为bl，根可能出现红红相连
+tree* RBtree::joinright(tree *l,int bl,tree *k,tree *r,int br)
+{
+    if(l->col==black&&bl==br)
+        return joinnode(l,k,r,red);
+    tree *c=joinright(l->right,bl-(l->col==black),k,r,br);
+    l->right=c;
+    c->p=l;
+    set_size(l);
+    if(l->col==black&&c->col==red&&c->right->col==red)
+    {
+        c->right->col=black;
+        return rotl(l);
+    }
+    return l;
+}
+
+tree* RBtree::joinleft(tree *l,int bl,tree *k,tree *r,int br)
+{
+    if(r->col==black&&bl==br)
+        return joinnode(l,k,r,red);
+    tree *c=joinleft(l,bl,k,r->left,br-(r->col==black));
+    r->left=c;
+    c->p=r;
+    set_size(r);
+    if(r->col==black&&c->col==red&&c->left->col==red)
+    {
+        c->left->col=black;
+        return rotr(r);
+    }
+    return r;
+}
+
+//以结点k连接l与r，返回新根，bh为新树的黑高
+tree* RBtree::join(tree *l,int bl,tree *k,tree *r,int br,int &bh)
+{
+    tree *t;
+    if(bl>br)
+    {
+        t=joinright(l,bl,k,r,br);
+        bh=bl;
+        if(t->col==red&&t->right->col==red)
+        {
+            t->col=black;
+            bh++;
+        }
+    }
+    else if(br>bl)
+    {
+        t=joinleft(l,bl,k,r,br);
+        bh=br;
+        if(t->col==red&&t->left->col==red)
+        {
+            t->col=black;
+            bh++;
+        }
+    }
+    else if(l->col==black&&r->col==black)
+    {
+        t=joinnode(l,k,r,red);
+        bh=bl;
+    }
+    else
+    {
+        t=joinnode(l,k,r,black);
+        bh=bl+1;
+    }
+    t->p=nil;
+    return t;
+}
+
+//摘下t中最大的结点并返回，其余结点组成rest
+tree* RBtree::splitlast(tree *t,int bh,tree *&rest,int &restbh)
+{
+    int cb=bh-(t->col==black);
+    if(t->right==nil)
+    {
+        rest=t->left;
+        restbh=cb;
+        t->left=nil;
+        return t;
+    }
+    tree *r;
+    int rb;
+    tree *k=splitlast(t->right,cb,r,rb);
+    rest=join(t->left,cb,t,r,rb,restbh);
+    return k;
+}
+
+//不经中间结点连接l与r
+tree* RBtree::join2(tree *l,int bl,tree *r,int br,int &bh)
+{
+    if(l==nil)
+    {
+        bh=br;
+        return r;
+    }
+    if(r==nil)
+    {
+        bh=bl;
+        return l;
+    }
+    tree *rest;
+    int rb;
+    tree *k=splitlast(l,bl,rest,rb);
+    return join(rest,rb,k,r,br,bh);
+}
+
+//把t拆成关键字<key的l与>key的r；key在树中时返回该结点（已与树分离），否则返回NULL
+tree* RBtree::split(tree *t,int bh,int key,tree *&l,int &bl,tree *&r,int &br)
+{
+    if(t==nil)
+    {
+        l=r=nil;
+        bl=br=0;
+        return NULL;
+    }
+    int cb=bh-(t->col==black);
+    tree *a=t->left,*b=t->right,*m,*f;
+    int mb;
+    if(key==t->data)
+    {
+        l=a;
+        r=b;
+        bl=br=cb;
+        t->left=t->right=nil;
+        return t;
+    }
+    if(key<t->data)
+    {
+        f=split(a,cb,key,l,bl,m,mb);
+        r=join(m,mb,t,b,cb,br);
+    }
+    else
+    {
+        f=split(b,cb,key,m,mb,r,br);
+        l=join(a,cb,t,m,mb,bl);
+    }
+    return f;
+}
+
+//舍弃以x为根的整棵子树，运算结束后统一回收
+void RBtree::drop(tree *x,vector<tree*> &dropped)
+{
+    #pragma omp critical(rbdrop)
+    dropped.push_back(x);
+}
+
+tree* RBtree::uniontree(tree *a,int ba,tree *b,int bb,int &bh,vector<tree*> &dropped)
+{
+    if(a==nil)
+    {
+        bh=bb;
+        return b;
+    }
+    if(b==nil)
+    {
+        bh=ba;
+        return a;
+    }
+    int n=a->size+b->size,cb=bb-(b->col==black),al_h,ar_h,lh,rh;
+    tree *bl=b->left,*br=b->right,*al,*ar,*l,*r;
+    tree *f=split(a,ba,b->data,al,al_h,ar,ar_h);
+    if(f!=NULL) drop(f,dropped);                        //两边都有的关键字保留b中的结点
+    #pragma omp task shared(l,lh,dropped) if(n>RBCUTOFF)
+    l=uniontree(al,al_h,bl,cb,lh,dropped);
+    r=uniontree(ar,ar_h,br,cb,rh,dropped);
+    #pragma omp taskwait
+    return join(l,lh,b,r,rh,bh);
+}
+
+tree* RBtree::intersecttree(tree *a,int ba,tree *b,int bb,int &bh,vector<tree*> &dropped)
+{
+    if(a==nil||b==nil)
+    {
+        if(a!=nil) drop(a,dropped);
+        if(b!=nil) drop(b,dropped);
+        bh=0;
+        return nil;
+    }
+    int n=a->size+b->size,cb=bb-(b->col==black),al_h,ar_h,lh,rh;
+    tree *bl=b->left,*br=b->right,*al,*ar,*l,*r;
+    tree *f=split(a,ba,b->data,al,al_h,ar,ar_h);
+    #pragma omp task shared(l,lh,dropped) if(n>RBCUTOFF)
+    l=intersecttree(al,al_h,bl,cb,lh,dropped);
+    r=intersecttree(ar,ar_h,br,cb,rh,dropped);
+    #pragma omp taskwait
+    if(f!=NULL)
+    {
+        drop(f,dropped);
+        return join(l,lh,b,r,rh,bh);
+    }
+    b->left=b->right=nil;
+    drop(b,dropped);
+    return join2(l,lh,r,rh,bh);
+}
+
+tree* RBtree::differencetree(tree *a,int ba,tree *b,int bb,int &bh,vector<tree*> &dropped)
+{
+    if(a==nil||b==nil)
+    {
+        if(b!=nil) drop(b,dropped);
+        bh=ba;
+        return a;
+    }
+    int n=a->size+b->size,cb=bb-(b->col==black),al_h,ar_h,lh,rh;
+    tree *bl=b->left,*br=b->right,*al,*ar,*l,*r;
+    tree *f=split(a,ba,b->data,al,al_h,ar,ar_h);
+    if(f!=NULL) drop(f,dropped);
+    #pragma omp task shared(l,lh,dropped) if(n>RBCUTOFF)
+    l=differencetree(al,al_h,bl,cb,lh,dropped);
+    r=differencetree(ar,ar_h,br,cb,rh,dropped);
+    #pragma omp taskwait
+    b->left=b->right=nil;
+    drop(b,dropped);
+    return join2(l,lh,r,rh,bh);
+}
+
+//运算结果t成为本树；other清空，其结点池并入本树，舍弃的结点回收
+void RBtree::setresult(tree *t,RBtree &other,vector<tree*> &dropped)
+{
+    if(t!=nil)
+    {
+        t->p=nil;
+        t->col=black;                                   //join得到的根可能为红
+    }
+    root=t;
+    total=t->size;
+    other.root=NULL;
+    other.total=0;
+    pool.absorb(other.pool);
+    for(size_t i=0;i<dropped.size();i++)
+        freetree(dropped[i]);
+}
+
+//本树与right以关键字k连接：要求本树关键字都小于k、right的关键字都大于k，否则返回false且两树不变
+bool RBtree::RBjoin(int k,RBtree &right)
+{
+    tree *a=(root==NULL)?nil:root,*b=(right.root==NULL)?nil:right.root,*x;
+    int bh;
+    vector<tree*> dropped;
+    if(&right==this) return false;
+    for(x=a;x!=nil&&x->right!=nil;x=x->right);
+    if(x!=nil&&x->data>=k) return false;
+    for(x=b;x!=nil&&x->left!=nil;x=x->left);
+    if(x!=nil&&x->data<=k) return false;
+    x=RBtreenode(k);
+    setresult(join(a,blackheight(a),x,b,blackheight(b),bh),right,dropped);
+    return true;
+}
+
+//本树变为两树的并，other清空
+void RBtree::RBunion(RBtree &other)
+{
+    tree *a=(root==NULL)?nil:root,*b=(other.root==NULL)?nil:other.root,*t;
+    int bh;
+    vector<tree*> dropped;
+    if(&other==this) return;
+    if(a->size<b->size) std::swap(a,b);                 //用较小树的结点拆分较大的树
+    #pragma omp parallel
+    #pragma omp single
+    t=uniontree(a,blackheight(a),b,blackheight(b),bh,dropped);
+    setresult(t,other,dropped);
+}
+
+//本树变为两树的交，other清空
+void RBtree::RBintersection(RBtree &other)
+{
+    tree *a=(root==NULL)?nil:root,*b=(other.root==NULL)?nil:other.root,*t;
+    int bh;
+    vector<tree*> dropped;
+    if(&other==this) return;
+    if(a->size<b->size) std::swap(a,b);
+    #pragma omp parallel
+    #pragma omp single
+    t=intersecttree(a,blackheight(a),b,blackheight(b),bh,dropped);
+    setresult(t,other,dropped);
+}
+
+//本树变为本树减去other，other清空
+void RBtree::RBdifference(RBtree &other)
+{
+    tree *a=(root==NULL)?nil:root,*b=(other.root==NULL)?nil:other.root,*t;
+    int bh;
+    vector<tree*> dropped;
+    if(&other==this)
+    {
+        freetree(a);
+        root=NULL;
+        total=0;
+        return;
+    }
+    #pragma omp parallel
+    #pragma omp single
+    t=differencetree(a,blackheight(a),b,blackheight(b),bh,dropped);
+    setresult(t,other,dropped);
+}
@@ -1,21 +1,25 @@
 #include "RBtree.h"
+#include <algorithm>
+#include <climits>
+//所有RBtree共用一个只读的nil，两棵树的结点可以直接拼接；删除时不再借nil->p记录父结点
+static tree sharednil={0,black,0,NULL,NULL,NULL};
+
 RBtree::RBtree()
 {
-    nil=new tree;
-    nil->data=0;
-    nil->left=NULL;
-    nil->right=NULL;
-    nil->col=black;
-    nil->p=NULL;
+    nil=&sharednil;
     root=NULL;
     total=0;
-    outnum=0;
+}
+
+RBtree::~RBtree()
+{
 }
 
 tree* RBtree::RBtreenode(int num)
 {
-    tree *node=new tree;
+    tree *node=pool.alloc();
     node->data=num;
+    node->size=1;
     node->left=nil;
     node->right=nil;
     node->col=black;
@@ -24,8 +28,9 @@ tree* RBtree::RBtreenode(int num)
 
 tree* RBtree::createtree(int num)
 {
-    root=new tree;
+    root=pool.alloc();
     root->data=num;
+    root->size=1;
     root->left=nil;
     root->right=nil;
     root->col=black;
@@ -53,6 +58,8 @@ void RBtree::leftrotate(tree *x)
     }
     y->left=x;
     x->p=y;
+    set_size(x);
+    set_size(y);
 }
 
 void RBtree::rightrotate(tree *x)
@@ -74,6 +81,8 @@ void RBtree::rightrotate(tree *x)
     }
     y->right=x;
     x->p=y;
+    set_size(x);
+    set_size(y);
 }
 
 tree* RBtree::insertnode(tree* par,int num)
@@ -159,13 +168,73 @@ void RBtree::insertfixcolor(tree *z)
 
 bool RBtree::RBinsert(int num)
 {
+    if(root==NULL||root==nil)                           //空树时直接建根
+    {
+        createtree(num);
+        return true;
+    }
     tree *z=insertnode(root,num);
     if (z==NULL) return false;
+    for(tree *y=z->p;y!=nil;y=y->p)                     //沿插入路径向上更新size
+        y->size++;
     insertfixcolor(z);
     total++;
     return true;
 }
 
+void RBtree::freetree(tree *x)
+{
+    if(x==NULL||x==nil) return;
+    freetree(x->left);
+    freetree(x->right);
+    pool.release(x);
+}
+
+//以keys[l..r]的中点为根递归建树；左右子树规模至多差1，所有nil都在相邻两层，
+//因此把深度为reddepth的结点（最底层未满时的最底层）染红，其余染黑即满足红黑性质
+tree* RBtree::bulkbuild(int *keys,int l,int r,int depth,int reddepth,tree *par)
+{
+    if(l>r) return nil;
+    int mid=(l+r)/2;
+    tree *x=RBtreenode(keys[mid]);
+    x->p=par;
+    x->col=(depth==reddepth)?red:black;
+    x->left=bulkbuild(keys,l,mid-1,depth+1,reddepth,x);
+    x->right=bulkbuild(keys,mid+1,r,depth+1,reddepth,x);
+    x->size=r-l+1;
+    return x;
+}
+
+//由关键字数组线性时间建树，替换原有的树；sorted为false时先排序，重复关键字只保留一个
+//sorted为true但数组实际无序时返回false，原树不变
+bool RBtree::RBbulkload(int *keys,int n,bool sorted)
+{
+    int i,m,h;
+    if(n<0) return false;
+    int *buf=new int[n+1];
+    for(i=0;i<n;i++)
+        buf[i]=keys[i];
+    if(!sorted)
+        std::sort(buf,buf+n);
+    for(i=m=0;i<n;i++)                                  //去重，同时检查是否有序
+    {
+        if(m>0&&buf[i]<buf[m-1])
+        {
+            delete []buf;
+            return false;
+        }
+        if(m==0||buf[i]!=buf[m-1])
+            buf[m++]=buf[i];
+    }
+    freetree(root);
+    for(h=0;(2<<h)-1<m;h++);                            //h为最底层深度
+    root=bulkbuild(buf,0,m-1,0,((2<<h)-1==m)?-1:h,nil);
+    if(m==0) root=NULL;
+    total=m;
+    delete []buf;
+    return true;
+}
+
 void RBtree::RBTransplant(tree *u,tree *v)
 {    
     if (u->p == nil)
@@ -177,7 +246,8 @@ void RBtree::RBTransplant(tree *u,tree *v)
         else
         u->p->right = v;
     }
-    v->p = u->p;
+    if (v != nil)
+        v->p = u->p;
 }
 
 tree* RBtree::TreeMinimum(tree *x)
@@ -189,16 +259,18 @@ tree* RBtree::TreeMinimum(tree *x)
 
 void RBtree::RBnodeDelete(tree *z)
 {
-    tree *y=z,*x;
+    tree *y=z,*x,*xp;                                   //xp为x的父结点，x可能是nil
     color y_original_color = y->col;
     if (z->left == nil)
     {
         x = z->right;
+        xp = z->p;
         RBTransplant(z, z->right);
     }
     else if (z->right == nil)
     {
         x = z->left;
+        xp = z->p;
         RBTransplant(z, z->left);
     }
     else
@@ -207,9 +279,10 @@ void RBtree::RBnodeDelete(tree *z)
         y_original_color = y->col;
         x = y->right;
         if (y->p == z)
-            x->p = y;
+            xp = y;
         else
         {
+            xp = y->p;
             RBTransplant(y, y->right);
             y->right = z->right;
             y->right->p = y;
@@ -219,28 +292,32 @@ void RBtree::RBnodeDelete(tree *z)
         y->left->p = y;
         y->col = z->col;
     }
+    for (tree *u = xp; u != nil; u = u->p)              //从实际摘除结点的位置向上更新size
+        set_size(u);
     if (y_original_color == black)
-        RBnodeDeleteFixup(x);
+        RBnodeDeleteFixup(x, xp);
+    pool.release(z);
 }
 
-void RBtree::RBnodeDeleteFixup(tree *x)
+void RBtree::RBnodeDeleteFixup(tree *x,tree *xp)
 {
     tree *w;
     while ((x != root) && (x->col == black))
-        if (x == x->p->left)
+        if (x == xp->left)
         {
-            w = x->p->right;
+            w = xp->right;
             if (w->col == red)
             {
                 w->col = black;
-                x->p->col = red;
-                leftrotate(x->p);
-                w = x->p->right;
+                xp->col = red;
+                leftrotate(xp);
+                w = xp->right;
             }
             if ((w->left->col == black) && (w->right->col == black))
             { 
                 w->col=red;
-                x = x->p;
+                x = xp;
+                xp = x->p;
             }
             else
             {
@@ -249,29 +326,30 @@ void RBtree::RBnodeDeleteFixup(tree *x)
                     w->left->col = black;
                     w->col = red;
                     rightrotate(w);
-                    w = x->p->right;
+                    w = xp->right;
                 }
-                w->col = x->p->col;
-                x->p->col = black;
+                w->col = xp->col;
+                xp->col = black;
                 w->right->col = black;
-                leftrotate(x->p);
+                leftrotate(xp);
                 x = root;
             }
         }
         else
         {
-            w = x->p->left;
+            w = xp->left;
             if (w->col == red)
             {
                 w->col = black;
-                x->p->col = red;
-                rightrotate(x->p);
-                w = x->p->left;
+                xp->col = red;
+                rightrotate(xp);
+                w = xp->left;
             }
             if ((w->right->col == black) && (w->left->col == black))
             {
                 w->col = red;
-                x = x->p;
+                x = xp;
+                xp = x->p;
             }
             else
             {
@@ -280,70 +358,193 @@ void RBtree::RBnodeDeleteFixup(tree *x)
                     w->right->col = black;
                     w->col = red;
                     leftrotate(w);
-                    w = x->p->left;
+                    w = xp->left;
                 }
-                w->col = x->p->col;
-                x->p->col = black;
+                w->col = xp->col;
+                xp->col = black;
                 w->left->col = black;
-                rightrotate(x->p);
+                rightrotate(xp);
                 x =root;
             }
         }
-    x->col = black;
+    if (x != nil)
+        x->col = black;
 }
 
 bool RBtree::RBDelete(int num)
 {
-    tree *z=SearchRBnode(root,num);
+    tree *z=RBSearch(num);
     if(z==NULL) return false;
     RBnodeDelete(z);
     total--;
     return true;
 }
 
-void RBtree::treepreorderTraversal(tree *nextnode)
+//迭代式遍历：借助父指针逐个取下一个结点，不用递归和缓冲区，遍历结束时返回NULL
+tree* RBtree::inbegin()
+{
+    if(root==NULL||root==nil) return NULL;
+    return TreeMinimum(root);
+}
+
+tree* RBtree::innext(tree *x)
 {
-    //ofstream out;
-    if(nextnode==nil) return;
-    outtree[0][outnum]=nextnode->data;
-    outtree[1][outnum]=nextnode->col;
-    outnum++;
-    //cout<<outnum;
-    treepreorderTraversal(nextnode->left);
-    treepreorderTraversal(nextnode->right);
-    //out->open("tree_out->txt",ios::app);
-    //out->close();
-}
-
-void RBtree::treeinorderTraversal(tree *nextnode)
+    if(x->right!=nil) return TreeMinimum(x->right);
+    tree *y=x->p;
+    while(y!=nil&&x==y->right)
+    {
+        x=y;
+        y=y->p;
+    }
+    return (y==nil)?NULL:y;
+}
+
+tree* RBtree::prebegin()
 {
-    if(nextnode==nil) return;
-    treeinorderTraversal(nextnode->left);
-    
-    outtree[2][outnum]=nextnode->data;
-    outnum++;
-    treeinorderTraversal(nextnode->right);
+    if(root==NULL||root==nil) return NULL;
+    return root;
 }
 
+//先序的下一个结点：有孩子时取孩子，否则向上找到第一个从左边回来且有右孩子的祖先
+tree* RBtree::prenext(tree *x)
+{
+    if(x->left!=nil) return x->left;
+    if(x->right!=nil) return x->right;
+    for(tree *y=x->p;y!=nil;x=y,y=y->p)
+        if(x==y->left&&y->right!=nil)
+            return y->right;
+    return NULL;
+}
+
+//输出vis_tree的输入文件：结点数、先序关键字、先序颜色、中序关键字
 void RBtree::printtree()
 {
     ofstream out;
-    int i,j;
+    tree *x;
     out.open("input.txt");
-    outnum=0;
-    treepreorderTraversal(root);
-    outnum=0;
-    treeinorderTraversal(root);
     out<<total<<endl;
-    for(j=0;j<3;j++)
+    for(x=prebegin();x!=NULL;x=prenext(x))
+        out<<x->data<<' ';
+    out<<endl;
+    for(x=prebegin();x!=NULL;x=prenext(x))
+        out<<x->col<<' ';
+    out<<endl;
+    for(x=inbegin();x!=NULL;x=innext(x))
+        out<<x->data<<' ';
+    out<<endl;
+    out.close();
+}
+
+int RBtree::heightnode(tree *x)
+{
+    if(x==nil) return 0;
+    return 1+max(heightnode(x->left),heightnode(x->right));
+}
+
+//树高（根到最深叶子的结点数），空树为0
+int RBtree::height()
+{
+    if(root==NULL||root==nil) return 0;
+    return heightnode(root);
+}
+
+int RBtree::gettotal()
+{
+    return total;
+}
+
+//边遍历边写出DOT文件，格式同vis_tree的输出，可直接交给dot作图
+bool RBtree::exportdot(const char *file)
+{
+    ofstream out(file);
+    tree *x;
+    if(!out) return false;
+    out<<"digraph first2{"<<endl;
+    for(x=prebegin();x!=NULL;x=prenext(x))
     {
-        for(i=0;i<total;i++)
+        out<<x->data<<" [color="<<(x->col==red?"\"red\"":"\"black\"")<<"];"<<endl;
+        if(x->left!=nil) out<<x->data<<"->"<<x->left->data<<";"<<endl;
+        if(x->right!=nil) out<<x->data<<"->"<<x->right->data<<";"<<endl;
+    }
+    out<<"}"<<endl;
+    return true;
+}
+
+//边遍历边写出JSON：按先序排列的结点数组，孩子以关键字表示，没有孩子为null
+bool RBtree::exportjson(const char *file)
+{
+    ofstream out(file);
+    tree *x;
+    if(!out) return false;
+    out<<"{\"root\":";
+    if(prebegin()==NULL) out<<"null";
+    else out<<root->data;
+    out<<",\"nodes\":[";
+    for(x=prebegin();x!=NULL;x=prenext(x))
+    {
+        out<<(x==root?"\n":",\n")<<"{\"key\":"<<x->data<<",\"color\":"<<(x->col==red?"\"red\"":"\"black\"");
+        out<<",\"left\":";
+        if(x->left==nil) out<<"null";
+        else out<<x->left->data;
+        out<<",\"right\":";
+        if(x->right==nil) out<<"null";
+        else out<<x->right->data;
+        out<<"}";
+    }
+    out<<"]}"<<endl;
+    return true;
+}
+
+void RBtree::set_size(tree *z)
+{
+    z->size=z->left->size+z->right->size+1;
+}
+
+//关键字不大于key的结点个数；key在树中时即为它的名次（从1开始）
+int RBtree::rank(int key)
+{
+    int r=0;
+    if(root==NULL) return 0;
+    tree *x=root;
+    while(x!=nil)
+        if(key<x->data)
+            x=x->left;
+        else
         {
-            out<<outtree[j][i]<<' ';
+            r+=x->left->size+1;
+            x=x->right;
         }
-        out<<endl;
-    }
-    out.close();
+    return r;
+}
+
+//第i小（从1开始）的结点，i越界时返回NULL
+tree* RBtree::select(int i)
+{
+    if(root==NULL||root==nil||i<1||i>root->size) return NULL;
+    tree *x=root;
+    while(i!=x->left->size+1)
+        if(i<=x->left->size)
+            x=x->left;
+        else
+        {
+            i-=x->left->size+1;
+            x=x->right;
+        }
+    return x;
+}
+
+//关键字落在[lo,hi]内的结点个数
+int RBtree::countrange(int lo,int hi)
+{
+    if(lo>hi) return 0;
+    return rank(hi)-(lo==INT_MIN?0:rank(lo-1));
+}
+
+//查找关键字为num的结点，不存在时返回NULL；只读，可与Leftright的读者并发
+tree* RBtree::RBSearch(int num)
+{
+    if(root==NULL) return NULL;
+    return SearchRBnode(root,num);
 }
 
 tree* RBtree::SearchRBnode(tree *per,int num)
@@ -1,6 +1,10 @@
+#ifndef RBTREE_H
+#define RBTREE_H
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <vector>
+#include "Nodepool.h"
 using namespace std;
 
 enum color{
@@ -10,32 +14,68 @@ enum color{
 typedef struct tree{
     int data;
     color col;
+    int size;                                           //以该结点为根的子树结点数，nil为0
     tree *left,*right,*p;
 } tree;
 
 class RBtree{
 public:
-    int outtree[3][100];
-    int outnum;
     RBtree();
+    ~RBtree();
     tree *RBtreenode(int num);
     tree *createtree(int num);
     bool RBinsert(int num);
+    bool RBbulkload(int *keys,int n,bool sorted);
     void RBnodeDelete(tree *z);
     tree *SearchRBnode(tree *per,int num);
     bool RBDelete(int num);
-    void treeinorderTraversal(tree *nextnode);
-    void treepreorderTraversal(tree *nextnode);
+    tree *RBSearch(int num);
+    void set_size(tree *z);
+    int rank(int key);
+    tree *select(int i);
+    int countrange(int lo,int hi);
+    bool RBjoin(int k,RBtree &right);
+    void RBunion(RBtree &other);
+    void RBintersection(RBtree &other);
+    void RBdifference(RBtree &other);
+    tree *inbegin();
+    tree *innext(tree *x);
+    tree *prebegin();
+    tree *prenext(tree *x);
     void printtree();
+    int height();
+    int gettotal();
+    bool exportdot(const char *file);
+    bool exportjson(const char *file);
 private:
     tree *root;
     tree *nil;
     int total;
+    Nodepool<tree> pool;                                //结点池，结点成块分配并复用已删除结点
     void leftrotate(tree *x);
     void rightrotate(tree *x);
     tree* insertnode(tree* par,int num);
     void insertfixcolor(tree *z);
-    void RBnodeDeleteFixup(tree *x);
+    void RBnodeDeleteFixup(tree *x,tree *xp);
     void RBTransplant(tree *u,tree *v);
     tree* TreeMinimum(tree *x);
-};
\ No newline at end of file
+    int heightnode(tree *x);
+    void freetree(tree *x);
+    tree* bulkbuild(int *keys,int l,int r,int depth,int reddepth,tree *par);
+    int blackheight(tree *t);
+    tree* joinnode(tree *l,tree *k,tree *r,color c);
+    tree* rotl(tree *x);
+    tree* rotr(tree *x);
+    tree* joinright(tree *l,int bl,tree *k,tree *r,int br);
+    tree* joinleft(tree *l,int bl,tree *k,tree *r,int br);
+    tree* join(tree *l,int bl,tree *k,tree *r,int br,int &bh);
+    tree* join2(tree *l,int bl,tree *r,int br,int &bh);
+    tree* splitlast(tree *t,int bh,tree *&rest,int &restbh);
+    tree* split(tree *t,int bh,int key,tree *&l,int &bl,tree *&r,int &br);
+    tree* uniontree(tree *a,int ba,tree *b,int bb,int &bh,vector<tree*> &dropped);
+    tree* intersecttree(tree *a,int ba,tree *b,int bb,int &bh,vector<tree*> &dropped);
+    tree* differencetree(tree *a,int ba,tree *b,int bb,int &bh,vector<tree*> &dropped);
+    void drop(tree *x,vector<tree*> &dropped);
+    void setresult(tree *t,RBtree &other,vector<tree*> &dropped);
+};
+#endif
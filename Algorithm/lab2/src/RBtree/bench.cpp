@@ -0,0 +1,95 @@
+#include "RBtree.h"
+#include "Oplog.h"
+#include <stdlib.h>
+#include <chrono>
+using namespace std;
+
+//RBtree批量驱动：回放操作日志，输出吞吐量、单次操作延迟分位数与最终树高，每次回放输出一个JSON对象
+//用法：./bench gen 分布 操作数 文件 [-b] [-k 关键字范围] [-m 插入,删除,查找,查询]   生成日志，-b为二进制
+//      ./bench run 文件                                                           回放日志
+//      ./bench 分布 操作数 [-k 关键字范围] [-m ...]                                 生成后直接回放
+//分布为uniform、sequential或zipf；-m为四类操作的百分比，默认50,20,20,10
+static void replay(const char *name,vector<oprec> &ops)
+{
+    RBtree T;
+    long long n=ops.size(),i,hits=0;
+    vector<int> lat(n);
+    chrono::steady_clock::time_point t0=chrono::steady_clock::now(),t1,t2;
+    t1=t0;
+    for(i=0;i<n;i++)
+    {
+        int a=ops[i].a;
+        switch(ops[i].op)
+        {
+            case 'i':
+                hits+=T.RBinsert(a);
+                break;
+            case 'd':
+                hits+=T.RBDelete(a);
+                break;
+            case 's':
+                hits+=T.RBSearch(a)!=NULL;
+                break;
+            case 'o':
+                hits+=T.countrange(a,ops[i].b);
+                break;
+        }
+        t2=chrono::steady_clock::now();
+        lat[i]=(int)chrono::duration_cast<chrono::nanoseconds>(t2-t1).count();
+        t1=t2;
+    }
+    double t=chrono::duration<double>(t1-t0).count();
+    sort(lat.begin(),lat.end());
+    printf("{\"tree\":\"RBtree\",\"log\":\"%s\",\"ops\":%lld,\"seconds\":%.6f,\"ops_per_sec\":%.0f,",
+        name,n,t,t>0?n/t:0);
+    if(n>0)
+        printf("\"p50_ns\":%d,\"p90_ns\":%d,\"p99_ns\":%d,\"p999_ns\":%d,\"max_ns\":%d,",
+            lat[n/2],lat[n*9/10],lat[n*99/100],lat[n*999/1000],lat[n-1]);
+    printf("\"hits\":%lld,\"size\":%d,\"height\":%d}\n",hits,T.gettotal(),T.height());
+}
+
+int main(int argc,char *argv[])
+{
+    vector<oprec> ops;
+    int keys=1000000,mix[4]={50,20,20,10},i,first;
+    bool binary=false;
+    if(argc<3)
+    {
+        printf("Usage: %s gen dist ops file [-b] [-k keys] [-m i,d,s,o] | %s run file | %s dist ops\n",argv[0],argv[0],argv[0]);
+        return 1;
+    }
+    first=(strcmp(argv[1],"gen")==0)?5:3;
+    for(i=first;i<argc;i++)
+    {
+        if(strcmp(argv[i],"-b")==0) binary=true;
+        else if(strcmp(argv[i],"-k")==0&&i+1<argc) keys=atoi(argv[++i]);
+        else if(strcmp(argv[i],"-m")==0&&i+1<argc)
+            sscanf(argv[++i],"%d,%d,%d,%d",&mix[0],&mix[1],&mix[2],&mix[3]);
+    }
+    if(strcmp(argv[1],"run")==0)
+    {
+        if(!readoplog(argv[2],ops))
+        {
+            printf("Error:Can't read %s!\n",argv[2]);
+            return 1;
+        }
+        replay(argv[2],ops);
+        return 0;
+    }
+    if(strcmp(argv[1],"gen")==0)
+    {
+        if(argc<5||!genoplog(argv[2],atoll(argv[3]),keys,mix,1000,ops)||!writeoplog(argv[4],ops,binary))
+        {
+            printf("Error:Can't generate %s!\n",argc<5?"the log":argv[4]);
+            return 1;
+        }
+        return 0;
+    }
+    if(!genoplog(argv[1],atoll(argv[2]),keys,mix,1000,ops))
+    {
+        printf("Error:Unknown distribution %s!\n",argv[1]);
+        return 1;
+    }
+    replay(argv[1],ops);
+    return 0;
+}
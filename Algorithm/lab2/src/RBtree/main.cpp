@@ -1,21 +1,27 @@
-#include"RBtree.h"
+#include"PRBtree.h"
 
 int main()
 {
     RBtree *rb; 
     int k=1;
-    int mode,buf;
+    int mode,buf,ver,v;
+    PRBtree history;                                    //每次修改后的版本都保留在history中
     rb=new RBtree();
     printf("Welcome to build a RBtree!\n");
     printf("To build a RBtree,please input the root number:\n");
     scanf("%d",&buf);
     rb->createtree(buf);
+    ver=history.PRBinsert(0,buf);
     while(k)
     {
         printf("Choose the operation for RBtree:\n");
         printf("No.1:Insert a node.\n");
         printf("No.2:Delete a node.\n");
         printf("No.3:Draw the RBtree.\n");
+        printf("No.4:Search a number in an earlier version.\n");
+        printf("No.5:Count the numbers in a range.\n");
+        printf("No.6:Find the i-th smallest number.\n");
+        printf("No.7:Export the RBtree to tree.dot and tree.json.\n");
         scanf("%d",&mode);
         switch(mode)
         {
@@ -24,6 +30,11 @@ int main()
                 scanf("%d",&buf);
                 if(!rb->RBinsert(buf))
                     printf("Error:This number already exsit!\n");
+                else
+                {
+                    ver=history.PRBinsert(ver,buf);
+                    printf("Now at version %d.\n",ver);
+                }
                 break;
             }
             case 2:{
@@ -31,12 +42,48 @@ int main()
                 scanf("%d",&buf);
                 if(!rb->RBDelete(buf))
                     printf("Error:This number does not exsit!\n");
+                else
+                {
+                    ver=history.PRBDelete(ver,buf);
+                    printf("Now at version %d.\n",ver);
+                }
                 break;
             }
             case 3:{
                 rb->printtree();
                 exit(0);
             }
+            case 4:{
+                printf("Input the version and the number:\n");
+                scanf("%d%d",&v,&buf);
+                if(v<1||v>ver)
+                    printf("Error:This version does not exsit!\n");
+                else if(history.PRBSearch(v,buf))
+                    printf("%d is in version %d.\n",buf,v);
+                else printf("%d is not in version %d.\n",buf,v);
+                break;
+            }
+            case 5:{
+                printf("Input the range:\n");
+                scanf("%d%d",&v,&buf);
+                printf("%d numbers in [%d,%d].\n",rb->countrange(v,buf),v,buf);
+                break;
+            }
+            case 6:{
+                printf("Input i:\n");
+                scanf("%d",&v);
+                tree *x=rb->select(v);
+                if(x==NULL)
+                    printf("Error:i is out of range!\n");
+                else printf("The %d-th smallest number is %d.\n",v,x->data);
+                break;
+            }
+            case 7:{
+                if(rb->exportdot("tree.dot")&&rb->exportjson("tree.json"))
+                    printf("Exported to tree.dot and tree.json.\n");
+                else printf("Error:Can't write the files!\n");
+                break;
+            }
             default:{
                 break;
             }
@@ -2,7 +2,7 @@
 #include <fstream>
 #include <string>
 #include <vector>
-#include <map>
+#include <unordered_map>
 using namespace std;
 
  struct TreeNode {
@@ -10,7 +10,7 @@ using namespace std;
     int color;
     TreeNode *left;
     TreeNode *right;
-    TreeNode(int x, int y) : val(x), color(y), left(NULL), right(NULL) {}
+    TreeNode() : val(0), color(0), left(NULL), right(NULL) {}
 };
 
  struct sequence {
@@ -19,69 +19,167 @@ using namespace std;
 };
 
 
+//建树、遍历、检查都不用递归：结点存放在连续数组中，深度只受内存限制，10^6个结点的树也能一次处理
 class Solution {
-	TreeNode* buildTreeHelper(std::vector<sequence>& preorder, int& pin, int start, int end, std::vector<int>& inorder, std::map<int, int>& mp){
-        if( start > end){
-            return nullptr;
-        }
-
-        auto curr = preorder[pin++].val;
-        auto node = new TreeNode(curr, preorder[pin-1].color);
-        auto place = mp[curr];
-
-
-
-        node->left = buildTreeHelper(preorder, pin, start, place-1, inorder, mp );
-        node->right = buildTreeHelper(preorder, pin,  place+1, end, inorder, mp );
-        return node;
-    }
+    std::vector<TreeNode> nodes;
 public:
+    //由先序和中序重建：用哈希表记录每个关键字在中序中的位置，栈中保存尚未接上右孩子的结点。
+    //先序中下一个结点若在栈顶结点的中序位置之前则是它的左孩子，否则弹栈直到找到它作为右孩子的父结点
 	TreeNode* buildTree(std::vector<sequence>& preorder, std::vector<int>& inorder) {
-        int pstart=0;
-        std::map<int, int> mp;
-        for(int i=0; i < inorder.size(); ++i){
-            mp[inorder[i]] = i;
-        }
-        if( preorder.size() ==0 || inorder.size() == 0 || preorder.size() != inorder.size())
+        int n = preorder.size();
+        if( n == 0 || inorder.size() != preorder.size())
             return nullptr;
-        return buildTreeHelper(preorder, pstart, 0, inorder.size()-1, inorder, mp  );
-
+        std::unordered_map<int, int> mp;
+        mp.reserve(n);
+        for(int i=0; i < n; ++i){
+            if( !mp.insert(std::make_pair(inorder[i], i)).second ){
+                std::cout<<"Error: duplicate key "<<inorder[i]<<std::endl;
+                return nullptr;
+            }
+        }
+        nodes.assign(n, TreeNode());
+        std::vector<int> pos(n);
+        for(int i=0; i < n; ++i){
+            auto it = mp.find(preorder[i].val);
+            if( it == mp.end() ){
+                std::cout<<"Error: key "<<preorder[i].val<<" is not in inorder"<<std::endl;
+                return nullptr;
+            }
+            nodes[i].val = preorder[i].val;
+            nodes[i].color = preorder[i].color;
+            pos[i] = it->second;
+        }
+        std::vector<int> stack;
+        stack.push_back(0);
+        for(int i=1; i < n; ++i){
+            if( pos[i] < pos[stack.back()] ){
+                nodes[stack.back()].left = &nodes[i];
+            }
+            else{
+                int parent = -1;
+                while( !stack.empty() && pos[stack.back()] < pos[i] ){
+                    parent = stack.back();
+                    stack.pop_back();
+                }
+                nodes[parent].right = &nodes[i];
+            }
+            stack.push_back(i);
+        }
+        return &nodes[0];
     }
 
 
-    void PreOrder(TreeNode* T)//先序递归遍历
+    void PreOrder(TreeNode* T)//先序遍历
     {
-        if(T!=NULL)
+        std::vector<TreeNode*> stack;
+        if(T!=NULL) stack.push_back(T);
+        while(!stack.empty())
         {
+            T = stack.back();
+            stack.pop_back();
             std::cout<<T->val<<"("<<T->color<<")"<<" ";
-            PreOrder(T->left);
-            PreOrder(T->right);
+            if(T->right!=NULL) stack.push_back(T->right);
+            if(T->left!=NULL) stack.push_back(T->left);
         }
     }
 
 
-    void InOrder(TreeNode* T)//先序递归遍历
+    void InOrder(TreeNode* T)//中序遍历
     {
-        if(T!=NULL)
+        std::vector<TreeNode*> stack;
+        while(T!=NULL || !stack.empty())
         {
-
-            InOrder(T->left);
-
+            while(T!=NULL)
+            {
+                stack.push_back(T);
+                T = T->left;
+            }
+            T = stack.back();
+            stack.pop_back();
             std::cout<<T->val<<"("<<T->color<<")"<<" ";
-
-            InOrder(T->right);
+            T = T->right;
         }
     }
 
 
+    //检查红黑性质：中序有序、红结点无红孩子、各路径黑结点数相同；结果写到标准输出
+    bool Verify(TreeNode* root, std::vector<int>& inorder, std::vector<sequence>& preorder)
+    {
+        int n = preorder.size();
+        if(root == NULL)
+        {
+            std::cout<<"Error: the traversals do not form a tree"<<std::endl;
+            return false;
+        }
+        for(int i=1; i < n; ++i)
+            if(inorder[i-1] >= inorder[i])
+            {
+                std::cout<<"Error: inorder is not increasing at "<<inorder[i]<<std::endl;
+                return false;
+            }
+        std::vector<TreeNode*> stack;
+        TreeNode* T = root;
+        int k = 0;
+        while(T!=NULL || !stack.empty())                //重建的树的中序须与输入一致
+        {
+            while(T!=NULL)
+            {
+                stack.push_back(T);
+                T = T->left;
+            }
+            T = stack.back();
+            stack.pop_back();
+            if(T->val != inorder[k++])
+            {
+                std::cout<<"Error: preorder and inorder do not match at "<<T->val<<std::endl;
+                return false;
+            }
+            T = T->right;
+        }
+        //先序排列中孩子总在父结点之后，倒序扫描即可自底向上求黑高
+        std::vector<int> bh(n);
+        for(int i=n-1; i >= 0; --i)
+        {
+            T = &nodes[i];
+            int l = (T->left==NULL) ? 0 : bh[T->left-&nodes[0]];
+            int r = (T->right==NULL) ? 0 : bh[T->right-&nodes[0]];
+            if(l != r)
+            {
+                std::cout<<"Error: black heights differ below "<<T->val<<std::endl;
+                return false;
+            }
+            if(T->color == 0 && ((T->left!=NULL && T->left->color==0) || (T->right!=NULL && T->right->color==0)))
+            {
+                std::cout<<"Error: red node "<<T->val<<" has a red child"<<std::endl;
+                return false;
+            }
+            bh[i] = l + (T->color != 0);
+        }
+        if(root->color == 0)
+        {
+            std::cout<<"Error: the root is red"<<std::endl;
+            return false;
+        }
+        std::cout<<"RBtree verified: "<<n<<" nodes, black height "<<bh[0]<<std::endl;
+        return true;
+    }
 };
 
-void input_tree_info(char* file_name, std::vector<sequence>& preorder, std::vector<int>& inorder)
+bool input_tree_info(char* file_name, std::vector<sequence>& preorder, std::vector<int>& inorder)
 {
     FILE* input = fopen(file_name, "r");
+    if(input == NULL)
+    {
+        std::cout<<"Error: cannot open "<<file_name<<std::endl;
+        return false;
+    }
 
     int tree_size;
-    int file_tmp = fscanf(input, "%d", &tree_size);
+    if(fscanf(input, "%d", &tree_size) != 1 || tree_size < 0)
+    {
+        fclose(input);
+        return false;
+    }
 
     std::cout<<"tree_size: "<<tree_size<<std::endl;
     preorder.resize(tree_size);
@@ -90,99 +188,87 @@ void input_tree_info(char* file_name, std::vector<sequence>& preorder, std::vect
     int val;
     int i=0;
 
-    while(i<tree_size && fscanf(input, "%d", &val)!=EOF)
+    while(i<tree_size && fscanf(input, "%d", &val)==1)
     {
-
         preorder[i].val = val;
-
         i++;
     }
 
-
-
     i=0;
 
-    while(i<tree_size && fscanf(input, "%d", &val)!=EOF)
+    while(i<tree_size && fscanf(input, "%d", &val)==1)
     {
-
-         preorder[i].color = val;
-
+        preorder[i].color = val;
         i++;
     }
 
-
     i=0;
 
-    while(i<tree_size && fscanf(input, "%d", &val)!=EOF)
+    while(i<tree_size && fscanf(input, "%d", &val)==1)
     {
-         inorder[i] = val;
-
+        inorder[i] = val;
         i++;
     }
 
     fclose(input);
-
+    return i == tree_size;
 }
 
 
 
-void PreOrder_dot(TreeNode* T)//先序递归遍历
-{
-    if(T!=NULL)
-    {
-        if(T->left!=NULL)
-        {
-            std::cerr<<T->val<<"->"<<T->left->val<<";"<<std::endl;
-        }
-
-        if(T->right!=NULL)
-        {
-            std::cerr<<T->val<<"->"<<T->right->val<<";"<<std::endl;
-        }
-
-
-        PreOrder_dot(T->left);
-        PreOrder_dot(T->right);
-    }
-}
-
+//按先序逐个写出结点颜色和指向孩子的边，直接流式输出到标准错误
 void generate_dot_file(std::vector<sequence>& preorder, TreeNode* T)
 {
+    std::vector<TreeNode*> stack;
 
     std::cerr<<"digraph first2{"<<std::endl;
 
-    for(int i =0; i < preorder.size(); i++)
+    for(size_t i =0; i < preorder.size(); i++)
     {
         std::cerr<<preorder[i].val<<" [color=";
 
         if(preorder[i].color == 0)
         {
-            std::cerr<<"\"red\"];"<<std::endl;
+            std::cerr<<"\"red\"];\n";
         }
         else
         {
-            std::cerr<<"\"black\"];"<<std::endl;
+            std::cerr<<"\"black\"];\n";
         }
 
     }
 
-    PreOrder_dot(T);
+    if(T!=NULL) stack.push_back(T);
+    while(!stack.empty())
+    {
+        T = stack.back();
+        stack.pop_back();
+        if(T->left!=NULL)
+        {
+            std::cerr<<T->val<<"->"<<T->left->val<<";\n";
+        }
+
+        if(T->right!=NULL)
+        {
+            std::cerr<<T->val<<"->"<<T->right->val<<";\n";
+        }
+        if(T->right!=NULL) stack.push_back(T->right);
+        if(T->left!=NULL) stack.push_back(T->left);
+    }
 
     std::cerr<<"}";
 }
 
 int main(int argc, char** argv)
 {
-
-
     std::vector<sequence> preorder;
     std::vector<int> inorder;
 
-
-
-	input_tree_info(argv[1], preorder, inorder);
-
-
+    if(argc < 2 || !input_tree_info(argv[1], preorder, inorder))
+    {
+        std::cout<<"Error: bad input file"<<std::endl;
+        return 1;
+    }
 
 	Solution tree;
 
@@ -198,8 +284,9 @@ int main(int argc, char** argv)
 	tree.InOrder(T);
 	std::cout<<std::endl;
 
+    bool ok = tree.Verify(root, inorder, preorder);
 
 	generate_dot_file(preorder, root);
 
-	return 0;
+	return ok ? 0 : 1;
 }
@@ -0,0 +1,165 @@
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "LCS.h"
+#include "Bitlcs.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(__x86_64__)||defined(__i386__)
+#include <immintrin.h>
+#define LCS_X86
+#endif
+
+//bit-parallel LCS length (Allison-Dix, in Hyyro's form): one bit per position j of the pattern b,
+//bit j of V is 1 when row[j+1]==row[j] in the current row of the DP table, so a row of lb cells lives in
+//ceil(lb/64) words. one character ch of the text a updates the whole row with
+//    U=V&M[ch]; V=(V+U)|(V&~M[ch])
+//where M[ch] marks the positions of ch in b; the carry of the addition runs across the words.
+//after the whole text, row[j]=j-(ones of V below j) and the LCS length is the number of zeros
+
+//match masks for the symbols that occur in b; the other symbols map to slot 0, whose mask is zero
+//(they leave V unchanged and are skipped)
+void buildpattern(const char *b, int lb, bool reverse, int B, bitpattern &p)
+{
+	int i;
+	if(B<1)
+		B=1;
+	p.lb=lb;
+	p.B=B;
+	p.W=((lb+63)/64+B-1)/B*B;
+	p.nsym=1;
+	for(i = 0; i < 256; i++)
+		p.slot[i]=0;
+	for(i = 0; i < lb; i++)
+	{
+		unsigned char c=b[i];
+		if(p.slot[c]==0)
+			p.slot[c]=p.nsym++;
+	}
+	p.masks.assign((size_t)p.nsym*p.W,0);
+	for(i = 0; i < lb; i++)
+	{
+		int j=reverse?lb-1-i:i;             //position in the (reversed) pattern
+		int k=j>>6;
+		p.masks[((size_t)(k/B)*p.nsym+p.slot[(unsigned char)b[i]])*B+k%B]|=(uint64_t)1<<(j&63);
+	}
+}
+
+static uint64_t bitstep(uint64_t *V, const uint64_t *M, int W, uint64_t carry)
+{
+	for(int k = 0; k < W; k++)
+	{
+		uint64_t v=V[k],u=v&M[k];
+		uint64_t t=v+carry;
+		uint64_t s=t+u;
+		carry=(t<carry)|(s<u);
+		V[k]=s|(v&~M[k]);
+	}
+	return carry;
+}
+
+#ifdef LCS_X86
+//AVX2 step: four words are added without carries, then the carries between them are found at once
+//from two 4-bit masks, g (the word overflowed) and p (the word is all ones and passes a carry on):
+//the carry into each word is (((g<<1)|carry)+p)^p, the same rule as a 4-digit binary addition
+__attribute__((target("avx2")))
+static uint64_t bitstepavx2(uint64_t *V, const uint64_t *M, int W, uint64_t carry)
+{
+	static const uint64_t inc[16][4]={{0,0,0,0},{1,0,0,0},{0,1,0,0},{1,1,0,0},{0,0,1,0},{1,0,1,0},{0,1,1,0},{1,1,1,0},
+		{0,0,0,1},{1,0,0,1},{0,1,0,1},{1,1,0,1},{0,0,1,1},{1,0,1,1},{0,1,1,1},{1,1,1,1}};
+	const __m256i sign=_mm256_set1_epi64x((long long)0x8000000000000000ULL),ones=_mm256_set1_epi64x(-1);
+	int k;
+	for(k = 0; k+4 <= W; k += 4)
+	{
+		__m256i v=_mm256_loadu_si256((const __m256i*)(V+k));
+		__m256i m=_mm256_loadu_si256((const __m256i*)(M+k));
+		__m256i s=_mm256_add_epi64(v,_mm256_and_si256(v,m));
+		__m256i over=_mm256_cmpgt_epi64(_mm256_xor_si256(v,sign),_mm256_xor_si256(s,sign));   //unsigned s<v
+		unsigned g=_mm256_movemask_pd(_mm256_castsi256_pd(over));
+		unsigned p=_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(s,ones)));
+		unsigned c=(((g<<1)|(unsigned)carry)+p)^p;
+		carry=c>>4;
+		s=_mm256_add_epi64(s,_mm256_loadu_si256((const __m256i*)inc[c&15]));
+		_mm256_storeu_si256((__m256i*)(V+k),_mm256_or_si256(s,_mm256_andnot_si256(m,v)));
+	}
+	return bitstep(V+k,M+k,W-k,carry);
+}
+#endif
+
+bitstepfunc pickstep(bool usesimd, int W)
+{
+#ifdef LCS_X86
+	static const bool hasavx2=__builtin_cpu_supports("avx2");
+	if(usesimd && hasavx2 && W>=8)           //short patterns do not fill enough vectors to pay off
+		return bitstepavx2;
+#endif
+	return bitstep;
+}
+
+//run the text a over the pattern b and leave the final bit vector in V (at least ceil(lb/64) words).
+//with parallel and more than one OpenMP thread, large problems go to the tiled wavefront with
+//about 8 tiles per thread along each side
+static void bitrun(const char *a, int la, const char *b, int lb, bool reverse, bool usesimd, bool parallel, std::vector<uint64_t> &V)
+{
+	bitpattern p;
+	int i,W=(lb+63)/64,threads=1;
+#ifdef _OPENMP
+	if(parallel)
+		threads=omp_get_max_threads();
+#endif
+	if(threads>1 && W>=2*WFMINWORDS && la>=2*WFMINCHARS)
+	{
+		int B=(W+8*threads-1)/(8*threads),C=(la+8*threads-1)/(8*threads);
+		if(B<WFMINWORDS) B=WFMINWORDS;
+		if(C<WFMINCHARS) C=WFMINCHARS;
+		buildpattern(b,lb,reverse,(B+3)/4*4,p);
+		wavefrontrun(a,la,reverse,p,C,usesimd,V);
+		return;
+	}
+	buildpattern(b,lb,reverse,W,p);
+	V.assign(p.W,~(uint64_t)0);
+	bitstepfunc step=pickstep(usesimd,p.W);
+	for(i = 0; i < la; i++)
+	{
+		int s=p.slot[(unsigned char)(reverse?a[la-1-i]:a[i])];
+		if(s!=0)
+			step(&V[0],&p.masks[(size_t)s*p.W],p.W,0);
+	}
+}
+
+//LCS length only: the shorter sequence is the pattern, so the work is
+//max(l1,l2)*ceil(min(l1,l2)/64) word steps and the memory O(min(l1,l2)) words per distinct symbol
+int LCSbitlength(const char *s1, int l1, const char *s2, int l2, bool usesimd, bool parallel)
+{
+	std::vector<uint64_t> V;
+	int k,len;
+	if(l2>l1)
+	{
+		std::swap(s1,s2);
+		std::swap(l1,l2);
+	}
+	if(l2==0)
+		return 0;
+	bitrun(s1,l1,s2,l2,false,usesimd,parallel,V);
+	len=l2;
+	for(k = 0; k < l2/64; k++)
+		len-=__builtin_popcountll(V[k]);
+	if(l2&63)
+		len-=__builtin_popcountll(V[k]&(((uint64_t)1<<(l2&63))-1));
+	return len;
+}
+
+//the same last row LCSrow computes, from the bit vector: row[j]=j-(ones of V below j)
+void LCSbitrow(const char *a, int la, const char *b, int lb, int *row, bool reverse)
+{
+	std::vector<uint64_t> V;
+	int j,ones=0;
+	bitrun(a,la,b,lb,reverse,true,true,V);
+	row[0]=0;
+	for(j = 1; j < lb+1; j++)
+	{
+		ones+=(V[(j-1)>>6]>>((j-1)&63))&1;
+		row[j]=j-ones;
+	}
+}
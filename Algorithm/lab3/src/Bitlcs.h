@@ -0,0 +1,25 @@
+#ifndef BITLCS_H
+#define BITLCS_H
+#include <vector>
+#include <stdint.h>
+#define WFMINWORDS 16                       //smallest wavefront tile: 1024 pattern positions
+#define WFMINCHARS 1024                     //by 1024 text symbols
+
+//match masks of a pattern, cut into blocks of B words so that a tile of the wavefront reads
+//one contiguous piece: the masks of all symbols for block k start at masks[k*nsym*B]
+typedef struct bitpattern{
+	int lb;                                 //pattern length
+	int W;                                  //words, a multiple of B; words past the pattern stay zero
+	int B;                                  //words per block
+	int nsym;                               //distinct symbols + 1, slot 0 is the all-zero mask
+	int slot[256];
+	std::vector<uint64_t> masks;
+} bitpattern;
+
+//one text symbol over W words of V with a carry coming in from below, returns the carry going out
+typedef uint64_t (*bitstepfunc)(uint64_t *V, const uint64_t *M, int W, uint64_t carry);
+
+void buildpattern(const char *b, int lb, bool reverse, int B, bitpattern &p);
+bitstepfunc pickstep(bool usesimd, int W);
+void wavefrontrun(const char *a, int la, bool reverse, bitpattern &p, int C, bool usesimd, std::vector<uint64_t> &V);
+#endif
@@ -0,0 +1,493 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "LCS.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define DIFFMATCHES (1<<24)                 //match pairs one Hunt-Szymanski run may visit
+
+//line diff: both files are mapped into memory, every line (with its line break) is hashed to 64 bits and
+//becomes an integer token, lines of equal hash get equal tokens, and the LCS of the two token sequences
+//gives the lines both files keep. the kept pairs are compared byte by byte at the end, and a hash
+//collision among them (about n*n/2^64 likely) runs the diff again with another seed.
+//the LCS is found with Hunt-Szymanski, which only visits pairs of equal lines: O((r+n)log n) for r
+//such pairs instead of the n*m table. before that, a common head and tail are cut off, and a range
+//with too many pairs is split at lines that occur exactly once in both files, or solved by Myers when
+//there are none
+
+struct mapped{
+	const char *data;
+	size_t size;
+	int fd;
+	struct stat st;
+};
+
+static bool mapfile(const char *file, mapped &m)
+{
+	m.data=NULL;
+	m.fd=open(file,O_RDONLY);
+	if(m.fd<0)
+		return false;
+	if(fstat(m.fd,&m.st)<0)
+	{
+		close(m.fd);
+		return false;
+	}
+	m.size=m.st.st_size;
+	if(m.size==0)                           //an empty file can not be mapped
+		return true;
+	void *p=mmap(NULL,m.size,PROT_READ,MAP_PRIVATE,m.fd,0);
+	if(p==MAP_FAILED)
+	{
+		close(m.fd);
+		return false;
+	}
+	madvise(p,m.size,MADV_SEQUENTIAL);
+	m.data=(const char*)p;
+	return true;
+}
+
+static void unmapfile(mapped &m)
+{
+	if(m.size>0)
+		munmap((void*)m.data,m.size);
+	close(m.fd);
+}
+
+//start of the line after the one at p
+static inline const char *nextline(const char *p, const char *end)
+{
+	const char *q=(const char*)memchr(p,'\n',end-p);
+	return q?q+1:end;
+}
+
+static uint64_t linehash(const char *s, size_t n, uint64_t seed)
+{
+	uint64_t h=(n+seed)*0x9E3779B97F4A7C15ULL,w;
+	size_t i;
+	for(i = 0; i+8 <= n; i += 8)
+	{
+		memcpy(&w,s+i,8);
+		h=(h^w)*0xff51afd7ed558ccdULL;
+		h^=h>>32;
+	}
+	w=0;
+	memcpy(&w,s+i,n-i);
+	h=(h^w)*0xc4ceb9fe1a85ec53ULL;
+	return h^(h>>29);
+}
+
+//hash of every line, with its line break; the file is cut at line breaks into pieces hashed in parallel
+static void hashlines(const mapped &m, uint64_t seed, std::vector<uint64_t> &h)
+{
+	int k,pieces=1;
+#ifdef _OPENMP
+	pieces=omp_get_max_threads()*4;
+#endif
+	if((size_t)pieces>m.size/(1<<20)+1)
+		pieces=m.size/(1<<20)+1;
+	std::vector<const char*> cut(pieces+1);
+	std::vector<std::vector<uint64_t> > part(pieces);
+	cut[0]=m.data;
+	cut[pieces]=m.data+m.size;
+	for(k = 1; k < pieces; k++)
+	{
+		cut[k]=std::max(cut[k-1],nextline(m.data+m.size/pieces*k,cut[pieces]));
+	}
+#pragma omp parallel for schedule(dynamic,1)
+	for(k = 0; k < pieces; k++)
+	{
+		const char *p=cut[k];
+		while(p<cut[k+1])
+		{
+			const char *q=nextline(p,cut[k+1]);
+			part[k].push_back(linehash(p,q-p,seed));
+			p=q;
+		}
+	}
+	h.clear();
+	for(k = 0; k < pieces; k++)
+		h.insert(h.end(),part[k].begin(),part[k].end());
+}
+
+//distinct line hashes of both files. a slot holds the high half of the hash, which also picks the slot,
+//and the token+1 (0 is empty), so a probe touches one word unless the halves agree
+struct linetable{
+	std::vector<uint64_t> slot;
+	std::vector<uint64_t> hash;
+
+	linetable():slot(1<<16,0){}
+	void prefetch(uint64_t h) const
+	{
+		__builtin_prefetch(&slot[(h>>32)&(slot.size()-1)]);
+	}
+	//room for n more tokens with the table at most half full
+	void reserve(size_t n)
+	{
+		size_t size=slot.size(),mask,k;
+		while((hash.size()+n)*2>size)
+			size*=2;
+		if(size==slot.size())
+			return;
+		std::vector<uint64_t> old(size,0);
+		old.swap(slot);
+		mask=size-1;
+		for(size_t i = 0; i < old.size(); i++)
+			if(old[i]!=0)
+			{
+				for(k = (old[i]>>32)&mask; slot[k]!=0; k = (k+1)&mask);
+				slot[k]=old[i];
+			}
+	}
+	int intern(uint64_t h)
+	{
+		size_t mask=slot.size()-1,k;
+		uint64_t tag=h>>32;
+		if((hash.size()+1)*2>slot.size())
+		{
+			reserve(slot.size()/2);
+			mask=slot.size()-1;
+		}
+		for(k = tag&mask; slot[k]!=0; k = (k+1)&mask)
+			if((slot[k]>>32)==tag && hash[(uint32_t)slot[k]-1]==h)
+				return (uint32_t)slot[k]-1;
+		slot[k]=tag<<32|(uint32_t)(hash.size()+1);
+		hash.push_back(h);
+		return hash.size()-1;
+	}
+};
+
+//the tokens of the lines; the probe for a line is prefetched a few lines ahead
+static void tokenize(const std::vector<uint64_t> &h, linetable &t, std::vector<int> &tok)
+{
+	size_t i,n=h.size();
+	tok.resize(n);
+	for(i = 0; i < n; i++)
+	{
+		if(i+16<n)
+			t.prefetch(h[i+16]);
+		tok[i]=t.intern(h[i]);
+	}
+}
+
+//state shared by the recursion: ca[i]/cb[j] is 1 while line i of a / j of b is not known to be in the LCS.
+//the per-token arrays are all zero between calls, so each range only pays for its own lines
+struct diffstate{
+	const int *a,*b;
+	std::vector<char> ca,cb;
+	std::vector<int> cnta,cntb,where;
+};
+
+struct hsnode{
+	int i,j,prev;
+};
+
+//Hunt-Szymanski on a[a0..a1) and b[b0..b1), cntb holding the counts of the b range: for each line of a,
+//its equal lines in b are visited from the last to the first, and T[k], the smallest end in b of a
+//common subsequence of length k+1, is lowered by binary search
+static void hunt(diffstate &s, int a0, int a1, int b0, int b1)
+{
+	std::vector<int> pos(b1-b0),T,L;
+	std::vector<hsnode> nodes;
+	int i,j,k,q,off=0;
+	for(j = b0; j < b1; j++)                //bucket of each token, filled backwards so it runs from the last line
+		if(s.where[s.b[j]]==0)
+		{
+			off+=s.cntb[s.b[j]];
+			s.where[s.b[j]]=off;
+		}
+	for(j = b0; j < b1; j++)
+		pos[--s.where[s.b[j]]]=j;
+	for(i = a0; i < a1; i++)
+	{
+		int t=s.a[i],c=s.cntb[t],hi=T.size();
+		if(c==0)
+			continue;
+		const int *p=&pos[s.where[t]];
+		for(q = 0; q < c; q++)
+		{
+			j=p[q];
+			if(hi==(int)T.size() && (hi==0 || T[hi-1]<j))
+				k=hi;                       //extends the longest run, the usual case for similar files
+			else
+				k=std::lower_bound(T.begin(),T.begin()+hi,j)-T.begin();
+			hi=k;                           //the next j is smaller, so it lands at k or before
+			if(k<(int)T.size() && T[k]==j)
+				continue;
+			hsnode n={i,j,k>0?L[k-1]:-1};
+			nodes.push_back(n);
+			if(k==(int)T.size())
+			{
+				T.push_back(j);
+				L.push_back(nodes.size()-1);
+			}
+			else
+			{
+				T[k]=j;
+				L[k]=nodes.size()-1;
+			}
+		}
+	}
+	for(j = b0; j < b1; j++)
+		s.where[s.b[j]]=0;
+	for(k = L.empty()?-1:L.back(); k >= 0; k = nodes[k].prev)
+		s.ca[nodes[k].i]=s.cb[nodes[k].j]=0;
+}
+
+static void diffrange(diffstate &s, int a0, int a1, int b0, int b1)
+{
+	int i,j;
+	long long r=0;
+	while(a0<a1 && b0<b1 && s.a[a0]==s.b[b0])
+	{
+		s.ca[a0++]=0;
+		s.cb[b0++]=0;
+	}
+	while(a0<a1 && b0<b1 && s.a[a1-1]==s.b[b1-1])
+	{
+		s.ca[--a1]=0;
+		s.cb[--b1]=0;
+	}
+	if(a0==a1 || b0==b1)
+		return;
+	for(j = b0; j < b1; j++)
+		s.cntb[s.b[j]]++;
+	for(i = a0; i < a1; i++)
+		r+=s.cntb[s.a[i]];
+	if(r<=DIFFMATCHES)
+	{
+		hunt(s,a0,a1,b0,b1);
+		for(j = b0; j < b1; j++)
+			s.cntb[s.b[j]]=0;
+		return;
+	}
+
+	//too many pairs: the lines found once in each range, in an order both ranges agree on
+	//(longest increasing run of their b positions), are kept and the gaps between them solved alone
+	std::vector<int> ai,bj,tail,prev;
+	for(i = a0; i < a1; i++)
+		s.cnta[s.a[i]]++;
+	for(j = b0; j < b1; j++)
+		if(s.cntb[s.b[j]]==1)
+			s.where[s.b[j]]=j;
+	for(i = a0; i < a1; i++)
+		if(s.cnta[s.a[i]]==1 && s.cntb[s.a[i]]==1)
+		{
+			ai.push_back(i);
+			bj.push_back(s.where[s.a[i]]);
+		}
+	for(j = b0; j < b1; j++)
+		s.where[s.b[j]]=0;
+	for(i = a0; i < a1; i++)
+		s.cnta[s.a[i]]=0;
+	for(j = b0; j < b1; j++)
+		s.cntb[s.b[j]]=0;
+	if(ai.empty())                          //nothing to split at: Myers, whose time only grows with the edits,
+	{                                       //and if there are too many of them both ranges are cut in half
+		std::string script;
+		if(!LCSmyers(s.a+a0,a1-a0,s.b+b0,b1-b0,DIFFMATCHES,script))
+		{
+			int am=a0+(a1-a0)/2,bm=b0+(b1-b0)/2;
+			diffrange(s,a0,am,b0,bm);
+			diffrange(s,am,a1,bm,b1);
+			return;
+		}
+		i=a0;
+		j=b0;
+		for(size_t k = 0; k < script.size(); k++)
+			if(script[k]=='=')
+				s.ca[i++]=s.cb[j++]=0;
+			else if(script[k]=='-')
+				i++;
+			else
+				j++;
+		return;
+	}
+	prev.resize(ai.size());
+	for(i = 0; i < (int)ai.size(); i++)     //patience sorting, tail[k] is the anchor ending a run of k+1
+	{
+		int k=std::lower_bound(tail.begin(),tail.end(),i,[&](int x,int y){return bj[x]<bj[y];})-tail.begin();
+		prev[i]=k>0?tail[k-1]:-1;
+		if(k==(int)tail.size())
+			tail.push_back(i);
+		else
+			tail[k]=i;
+	}
+	std::vector<int> run;
+	for(i = tail.back(); i >= 0; i = prev[i])
+		run.push_back(i);
+	for(i = run.size()-1; i >= 0; i--)
+	{
+		int x=run[i];
+		diffrange(s,a0,ai[x],b0,bj[x]);
+		s.ca[ai[x]]=s.cb[bj[x]]=0;
+		a0=ai[x]+1;
+		b0=bj[x]+1;
+	}
+	diffrange(s,a0,a1,b0,b1);
+}
+
+//sequential reader of the lines of a file, the hunks only move forward
+struct linecursor{
+	const char *p,*end;
+	int line;
+};
+
+static void printlines(linecursor &c, int from, int to, char mark, FILE *out)
+{
+	for(; c.line < from; c.line++)
+		c.p=nextline(c.p,c.end);
+	for(; c.line < to; c.line++)
+	{
+		const char *q=nextline(c.p,c.end);
+		putc(mark,out);
+		fwrite(c.p,1,q-c.p,out);
+		if(q==c.end && q[-1]!='\n')
+			fputs("\n\\ No newline at end of file\n",out);
+		c.p=q;
+	}
+}
+
+static void printheader(const char *mark, const char *name, const struct stat &st, FILE *out)
+{
+	char date[32],zone[8];
+	struct tm tm;
+	localtime_r(&st.st_mtime,&tm);
+	strftime(date,sizeof(date),"%Y-%m-%d %H:%M:%S",&tm);
+	strftime(zone,sizeof(zone),"%z",&tm);
+	fprintf(out,"%s %s\t%s.%09ld %s\n",mark,name,date,(long)st.st_mtim.tv_nsec,zone);
+}
+
+//unified range: a hunk of no lines names the line before it
+static void printrange(char mark, int start, int count, FILE *out)
+{
+	if(count==1)
+		fprintf(out,"%c%d",mark,start+1);
+	else
+		fprintf(out,"%c%d,%d",mark,count==0?start:start+1,count);
+}
+
+int LCSdiff(const char *file1, const char *file2, int context)
+{
+	static char buf[1<<20];
+	mapped m1,m2;
+	diffstate s;
+	std::vector<int> ta,tb;
+	int i,j,na,nb;
+	if(!mapfile(file1,m1))
+	{
+		printf("Can't read %s!\n",file1);
+		return 2;
+	}
+	if(!mapfile(file2,m2))
+	{
+		printf("Can't read %s!\n",file2);
+		unmapfile(m1);
+		return 2;
+	}
+	std::vector<uint64_t> h;
+	std::vector<int> blocks;                //a0,a1,b0,b1 of each changed block
+	for(uint64_t seed = 0; ; seed++)
+	{
+		int ntok;
+		{
+			linetable t;
+			hashlines(m1,seed,h);
+			t.reserve(h.size());            //the first file at once, the second adds what is new
+			tokenize(h,t,ta);
+			hashlines(m2,seed,h);
+			tokenize(h,t,tb);
+			ntok=t.hash.size();
+		}
+		std::vector<uint64_t>().swap(h);
+		na=ta.size();
+		nb=tb.size();
+		s.a=ta.data();
+		s.b=tb.data();
+		s.ca.assign(na,1);
+		s.cb.assign(nb,1);
+		s.cnta.assign(ntok,0);
+		s.cntb.assign(ntok,0);
+		s.where.assign(ntok,0);
+		diffrange(s,0,na,0,nb);
+
+		//changed blocks: a run of lines left out of a next to a run left out of b; the lines
+		//between two blocks are the LCS, equally many in both files, and are compared here
+		const char *p1=m1.data,*e1=m1.data+m1.size,*p2=m2.data,*e2=m2.data+m2.size;
+		bool same=true;
+		blocks.clear();
+		for(i=0,j=0; same && (i < na || j < nb); )
+		{
+			if(i<na && j<nb && !s.ca[i] && !s.cb[j])
+			{
+				const char *q1=nextline(p1,e1),*q2=nextline(p2,e2);
+				same=q1-p1==q2-p2 && memcmp(p1,p2,q1-p1)==0;
+				p1=q1;
+				p2=q2;
+				i++;
+				j++;
+				continue;
+			}
+			blocks.push_back(i);
+			for(; i < na && s.ca[i]; i++)
+				p1=nextline(p1,e1);
+			blocks.push_back(i);
+			blocks.push_back(j);
+			for(; j < nb && s.cb[j]; j++)
+				p2=nextline(p2,e2);
+			blocks.push_back(j);
+		}
+		if(same)
+			break;
+	}
+	if(blocks.empty())
+	{
+		unmapfile(m1);
+		unmapfile(m2);
+		return 0;
+	}
+
+	//blocks closer than 2*context lines share a hunk
+	setvbuf(stdout,buf,_IOFBF,sizeof(buf));
+	printheader("---",file1,m1.st,stdout);
+	printheader("+++",file2,m2.st,stdout);
+	linecursor c1={m1.data,m1.data+m1.size,0},c2={m2.data,m2.data+m2.size,0};
+	int nblock=blocks.size()/4,first,last;
+	for(first = 0; first < nblock; first = last+1)
+	{
+		const int *f=&blocks[first*4];
+		for(last = first; last+1 < nblock && blocks[(last+1)*4]-blocks[last*4+1] <= 2*context; last++);
+		const int *l=&blocks[last*4];
+		int ha0=std::max(0,f[0]-context),ha1=std::min(na,l[1]+context);
+		int hb0=f[2]-(f[0]-ha0),hb1=l[3]+(ha1-l[1]);
+		fputs("@@ ",stdout);
+		printrange('-',ha0,ha1-ha0,stdout);
+		putc(' ',stdout);
+		printrange('+',hb0,hb1-hb0,stdout);
+		fputs(" @@\n",stdout);
+		int at=ha0;
+		for(i = first; i <= last; i++)
+		{
+			const int *k=&blocks[i*4];
+			printlines(c1,at,k[0],' ',stdout);
+			printlines(c1,k[0],k[1],'-',stdout);
+			printlines(c2,k[2],k[3],'+',stdout);
+			at=k[1];
+		}
+		printlines(c1,at,ha1,' ',stdout);
+	}
+	fflush(stdout);
+	unmapfile(m1);
+	unmapfile(m2);
+	return 1;
+}
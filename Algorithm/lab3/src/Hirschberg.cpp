@@ -0,0 +1,88 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "LCS.h"
+
+#define HIRSCHCELLS (1<<16)                 //subproblems this small are solved by LCSpacked directly
+
+//last row of the LCS table of a against b: row[j]=LCS(a,b[0..j)) for j=0..lb.
+//with reverse both sequences are read backwards, so row[j]=LCS(a,b[lb-j..lb)).
+//rows of 64 cells and more go to the bit-parallel kernel
+void LCSrow(const char *a, int la, const char *b, int lb, int *row, bool reverse)
+{
+	int i,j;
+	if(lb>=64)
+	{
+		LCSbitrow(a,la,b,lb,row,reverse);
+		return;
+	}
+	for(j = 0; j < lb+1; j++)
+		row[j]=0;
+	for(i = 0; i < la; i++)
+	{
+		char ch=reverse?a[la-1-i]:a[i];
+		const char *bj=reverse?b+lb-1:b;    //b[j-1], read backwards when reverse
+		int step=reverse?-1:1;
+		int diag=0,left=0;                  //row[j-1] of the previous and of this row
+		for(j = 1; j < lb+1; j++,bj+=step)
+		{
+			int up=row[j];
+			int v=up>left?up:left;
+			int eq=-(ch==*bj);              //a match is random data, keep it out of the branch predictor
+			v=(v&~eq)|((diag+1)&eq);
+			row[j]=v;
+			left=v;
+			diag=up;
+		}
+	}
+}
+
+//split a in half, find where an optimal path crosses the middle row from the forward row of the
+//top half and the backward row of the bottom half, and solve the two corners on either side
+static void hirschberg(const char *a, int la, const char *b, int lb, int *f, int *g, std::string &out)
+{
+	int i,mid,k,best;
+	if(la==0 || lb==0)
+		return;
+	if((long long)la*lb<=HIRSCHCELLS)
+	{
+		LCSpacked(a,la,b,lb,out);
+		return;
+	}
+	if(la==1)
+	{
+		for(i = 0; i < lb; i++)
+			if(b[i]==a[0])
+			{
+				out.push_back(a[0]);
+				break;
+			}
+		return;
+	}
+	mid=la/2;
+	LCSrow(a,mid,b,lb,f,false);
+	LCSrow(a+mid,la-mid,b,lb,g,true);
+	for(k=0,best=-1,i=0; i < lb+1; i++)
+		if(f[i]+g[lb-i]>best)
+		{
+			best=f[i]+g[lb-i];
+			k=i;
+		}
+	hirschberg(a,mid,b,k,f,g,out);         //f and g are free again once k is known
+	hirschberg(a+mid,la-mid,b+k,lb-k,f,g,out);
+}
+
+//Hirschberg's algorithm: O(l1*l2) time, two rows of min(l1,l2)+1 ints besides the input
+//and the result; the rows are sized by the shorter sequence, the recursion halves the longer one
+int LCShirschberg(const char *s1, int l1, const char *s2, int l2, std::string &out)
+{
+	size_t start=out.size();
+	if(l2>l1)
+	{
+		std::swap(s1,s2);
+		std::swap(l1,l2);
+	}
+	std::vector<int> f(l2+1),g(l2+1);
+	hirschberg(s1,l1,s2,l2,&f[0],&g[0],out);
+	return out.size()-start;
+}
@@ -1,23 +1,26 @@
 #include <iostream>
 #include <string>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+#include "LCS.h"
 
-int LCS(char* s1, char* s2, int **b)
+int LCS(const char* s1, int l1, const char* s2, int l2, int **b)
 {
-	int i,j,l1,l2,len;
-	l1 = strlen(s1);
-	l2 = strlen(s2);
- 
+	int i,j,len;
+
 	//allocate the caculate array
-	int **c = new int*[l1+1]; 
+	int **c = new int*[l1+1];
 	for(i = 0; i < l1+1; i++)
 		c[i] = new int[l2+1];
- 
+
     //init the array
 	for(i = 0; i < l1+1; i++)
-		c[i][0]=0;       
+		c[i][0]=0;
 	for(j = 0; j < l2+1; j++)
-		c[0][j]=0;       
-    
+		c[0][j]=0;
+
     //use LCS algorithm
 	for(i = 1; i < l1+1; i++)
 	{
@@ -26,7 +29,7 @@ int LCS(char* s1, char* s2, int **b)
 			if(s1[i-1]==s2[j-1])
 			{
 				c[i][j]=c[i-1][j-1]+1;
-				b[i][j]=0;                  //get from (i-1,j-1)          
+				b[i][j]=0;                  //get from (i-1,j-1)
 			}
 			else if(c[i-1][j]>c[i][j-1])
 			{
@@ -41,47 +44,137 @@ int LCS(char* s1, char* s2, int **b)
 		}
 	}
 	len=c[l1][l2];
+	for(i = 0; i < l1+1; i++)
+		delete []c[i];
+	delete []c;
 	return len;
 }
 
-void printLCS(int **b, char *s1, int i, int j)
+void printLCS(int **b, const char *s1, int i, int j)
 {
 	if(i==0 || j==0)                        //finish print
-		return;                         
+		return;
 	if(b[i][j]==0)                          //print this letter && goto(i-1,j-1)
 	{
 		printLCS(b, s1, i-1, j-1);
-		printf("%c",s1[i-1]); 
+		printf("%c",s1[i-1]);
 	}
 	else if(b[i][j]==1)                     //goto (i-1,j)
 		printLCS(b, s1, i-1, j);
 	else                                    //goto (i,j-1)
 		printLCS(b, s1, i, j-1);
 }
- 
-int main()
+
+//same recurrence and tie rule as LCS(), but only two rows of lengths are kept and each
+//direction takes 2 bits (0 diag, 1 up, 2 left), 32 cells per word: l1*l2/4 bytes in total.
+//the traceback walks the packed matrix with a loop, so the LCS length is not limited by the stack
+int LCSpacked(const char *s1, int l1, const char *s2, int l2, std::string &out)
 {
-	char s1[100],s2[100];
-	int i,l1,l2,len;
+	int i,j,len;
+	size_t stride=(size_t)(l2+32)/32;       //words per row, cells 0..l2
+	std::vector<uint64_t> dir((size_t)(l1+1)*stride,0);
+	std::vector<int> prev(l2+1,0),cur(l2+1,0);
+	for(i = 1; i < l1+1; i++)
+	{
+		uint64_t *row=&dir[(size_t)i*stride];
+		char ch=s1[i-1];
+		uint64_t word=0;                    //directions of cells j&~31..j, stored when full
+		cur[0]=0;
+		for(j = 1; j < l2+1; j++)
+		{
+			int up=prev[j],left=cur[j-1];
+			uint64_t d=up>left?1:2;
+			int v=up>left?up:left;
+			int eq=-(ch==s2[j-1]);          //select without a branch, matches are unpredictable
+			v=(v&~eq)|((prev[j-1]+1)&eq);
+			d&=~(uint64_t)(int64_t)eq;
+			cur[j]=v;
+			word|=d<<((j&31)*2);
+			if((j&31)==31)
+			{
+				row[j>>5]=word;
+				word=0;
+			}
+		}
+		row[l2>>5]|=word;
+		prev.swap(cur);
+	}
+	len=prev[l2];
 
-    //get input
-	printf("Input the first string:\n");
-	std::cin>>s1;
-	printf("Input the second string:\n");
-	std::cin>>s2;
+	//walk back from (l1,l2), then reverse the collected letters
+	size_t start=out.size();
+	i=l1;
+	j=l2;
+	while(i>0 && j>0)
+	{
+		int d=(dir[(size_t)i*stride+(j>>5)]>>((j&31)*2))&3;
+		if(d==0)
+		{
+			out.push_back(s1[i-1]);
+			i--;
+			j--;
+		}
+		else if(d==1)
+			i--;
+		else
+			j--;
+	}
+	std::reverse(out.begin()+start,out.end());
+	return len;
+}
 
-    //allocate the direction array
-	l1 = strlen(s1);
-	l2 = strlen(s2);
+//the classic engine, kept as the reference implementation
+static int LCSdp(const std::string &s1, const std::string &s2, std::string &out)
+{
+	int l1=s1.size(),l2=s2.size(),i,len;
 	int **b = new int*[l1+1];
-	for(i= 0; i < l1+1; i++)
+	for(i = 0; i < l1+1; i++)
 		b[i] = new int[l2+1];
+	len=LCS(s1.data(),l1,s2.data(),l2,b);
+	std::string path;                       //the walk printLCS does, without recursion
+	int j=l2;
+	i=l1;
+	while(i>0 && j>0)
+	{
+		if(b[i][j]==0)
+		{
+			path.push_back(s1[i-1]);
+			i--;
+			j--;
+		}
+		else if(b[i][j]==1)
+			i--;
+		else
+			j--;
+	}
+	out.append(path.rbegin(),path.rend());
+	for(i = 0; i < l1+1; i++)
+		delete []b[i];
+	delete []b;
+	return len;
+}
+
+//run the engine on two sequences; engineauto is Myers' algorithm, which leaves sequences with many
+//edits to the packed directions (one sequence shorter than a machine word) or to Hirschberg
+int LCSsolve(int engine, const std::string &s1, const std::string &s2, std::string &out, std::string *script)
+{
+	int l1=s1.size(),l2=s2.size(),len;
+	size_t start=out.size();
+	if(engine==enginebit)
+		return LCSbitlength(s1.data(),l1,s2.data(),l2,true,true);
+	if(engine==engineauto || engine==enginemyers)
+	{
+		std::string own;
+		return LCSmyers(s1.data(),l1,s2.data(),l2,out,script?*script:own);
+	}
+	if(engine==enginepacked)
+		len=LCSpacked(s1.data(),l1,s2.data(),l2,out);
+	else if(engine==enginehirschberg)
+		len=LCShirschberg(s1.data(),l1,s2.data(),l2,out);
+	else
+		len=LCSdp(s1,s2,out);
+	if(script)
+		LCSscript(s1.data(),l1,s2.data(),l2,out.data()+start,len,*script);
+	return len;
+}
 
-    //get LCS result
-	len=LCS(s1,s2,b);
-	printf("The LCS length is:%d\n",len);
-	printf("The LCS is:");
-	printLCS(b,s1,l1,l2);
-	printf("\n");
-	return 0;
-}
\ No newline at end of file
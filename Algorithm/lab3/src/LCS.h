@@ -0,0 +1,43 @@
+#ifndef LCS_H
+#define LCS_H
+#include <string>
+
+enum{
+	engineauto=0,
+	enginedp,                               //full length and direction matrices
+	enginepacked,                           //2-bit direction matrix, iterative traceback
+	enginehirschberg,                       //linear space divide and conquer
+	enginebit,                              //bit-parallel, length only
+	enginemyers                             //O((l1+l2)D) for D edits, linear space
+};
+
+//classic DP: b must be (l1+1)x(l2+1), directions 0 diag, 1 up, -1 left
+int LCS(const char* s1, int l1, const char* s2, int l2, int **b);
+void printLCS(int **b, const char *s1, int i, int j);
+
+//all engines take explicit lengths, so any byte may appear in the sequences; those below
+//append one longest common subsequence to out
+int LCSpacked(const char *s1, int l1, const char *s2, int l2, std::string &out);
+int LCShirschberg(const char *s1, int l1, const char *s2, int l2, std::string &out);
+void LCSrow(const char *a, int la, const char *b, int lb, int *row, bool reverse);
+
+//bit-parallel kernels: 64 cells per word, AVX2 for patterns of 512 symbols and more;
+//with parallel large inputs run as a tiled wavefront on OMP_NUM_THREADS threads (LCSbitrow always may)
+int LCSbitlength(const char *s1, int l1, const char *s2, int l2, bool usesimd, bool parallel);
+void LCSbitrow(const char *a, int la, const char *b, int lb, int *row, bool reverse);
+
+//Myers' difference algorithm, falling back to Hirschberg when D is large. script gets one letter per step:
+//'=' a letter of the LCS, '-' a letter of s1 deleted, '+' a letter of s2 inserted
+int LCSmyers(const char *s1, int l1, const char *s2, int l2, std::string &out, std::string &script);
+void LCSscript(const char *s1, int l1, const char *s2, int l2, const char *lcs, int len, std::string &script);
+//the same on integer tokens without the fallback: false, and script unchanged, after more than limit steps
+bool LCSmyers(const int *a, int n, const int *b, int m, long long limit, std::string &script);
+
+//unified diff of two files by lines (Hunt-Szymanski over line tokens), context lines around each
+//change; returns 0 when the files are equal, 1 when they differ and 2 when one can not be read
+int LCSdiff(const char *file1, const char *file2, int context);
+
+//what main runs; enginebit returns the length and leaves out unchanged,
+//the other engines also append the edit script to *script unless it is NULL
+int LCSsolve(int engine, const std::string &s1, const std::string &s2, std::string &out, std::string *script);
+#endif
@@ -0,0 +1,194 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include "LCS.h"
+
+#define MYERSWORK 16                        //word steps of the bit-parallel table per step the search may take
+
+//Myers' difference algorithm: D edits (deletions from s1, insertions from s2) turn s1 into s2 and
+//LCS=(l1+l2-D)/2. the furthest reaching path with d edits on diagonal k=x-y only needs the d-1 paths
+//on diagonals k-1 and k+1 followed by a run of equal letters (a snake), so a search to D takes
+//O((l1+l2)D) steps, and far fewer when the sequences are close
+
+struct myersstate{
+	std::vector<int> vf,vb;                 //furthest x on diagonal k, at index k+off, forward and backward
+	int off;
+	std::string *script;
+};
+
+//the middle snake of a[0..n) and b[0..m): the forward search from (0,0) and the backward search from
+//(n,m) take one more edit in turn until their furthest paths on a diagonal overlap; the last snake of
+//the path that got there, (x,y)-(u,v), lies on a shortest edit path. returns D, or -1 after more than
+//limit steps. T is a letter, or a line token of the diff
+template<class T>
+static int midsnake(myersstate &s, const T *a, int n, const T *b, int m, long long limit, int &x, int &y, int &u, int &v)
+{
+	int *vf=&s.vf[s.off],*vb=&s.vb[s.off];
+	int delta=n-m,d,k,maxd=(n+m+1)/2;
+	bool odd=delta&1;
+	long long work=0;
+	vf[1]=0;
+	vb[1]=0;
+	for(d = 0; d <= maxd; d++)
+	{
+		if(work>limit)
+			return -1;
+		work+=2*d+2;
+		for(k = -d; k <= d; k += 2)         //forward, x on diagonal k after d edits
+		{
+			int sx=(k==-d || (k!=d && vf[k-1]<vf[k+1]))?vf[k+1]:vf[k-1]+1,ex=sx,ey=sx-k;
+			while(ex<n && ey<m && a[ex]==b[ey])
+			{
+				ex++;
+				ey++;
+			}
+			work+=ex-sx;
+			vf[k]=ex;
+			if(odd && k>=delta-(d-1) && k<=delta+(d-1) && ex+vb[delta-k]>=n)
+			{
+				x=sx;
+				y=sx-k;
+				u=ex;
+				v=ey;
+				return 2*d-1;
+			}
+		}
+		for(k = -d; k <= d; k += 2)         //backward on the reversed sequences, diagonal k is delta-k forward
+		{
+			int sx=(k==-d || (k!=d && vb[k-1]<vb[k+1]))?vb[k+1]:vb[k-1]+1,ex=sx,ey=sx-k;
+			while(ex<n && ey<m && a[n-1-ex]==b[m-1-ey])
+			{
+				ex++;
+				ey++;
+			}
+			work+=ex-sx;
+			vb[k]=ex;
+			if(!odd && delta-k>=-d && delta-k<=d && ex+vf[delta-k]>=n)
+			{
+				x=n-ex;
+				y=m-ey;
+				u=n-sx;
+				v=m-(sx-k);
+				return 2*d;
+			}
+		}
+	}
+	return -1;                              //not reached, the paths meet by d=maxd
+}
+
+//edit script of a and b, split at the middle snake; with at most one edit the shorter sequence is a
+//subsequence of the longer one and is matched greedily
+template<class T>
+static void myers(myersstate &s, const T *a, int n, const T *b, int m, long long limit, bool &done)
+{
+	int x,y,u,v,i,j,D;
+	done=true;
+	if(n==0 || m==0)
+	{
+		s.script->append(n,'-');
+		s.script->append(m,'+');
+		return;
+	}
+	D=midsnake(s,a,n,b,m,limit,x,y,u,v);
+	if(D<0)
+	{
+		done=false;
+		return;
+	}
+	if(D>1)
+	{
+		myers(s,a,x,b,y,LLONG_MAX,done);   //both halves have at most half the edits, no limit below the top
+		s.script->append(u-x,'=');
+		myers(s,a+u,n-u,b+v,m-v,LLONG_MAX,done);
+		return;
+	}
+	for(i=0,j=0; i < n && j < m; )
+	{
+		if(a[i]==b[j])
+		{
+			s.script->push_back('=');
+			i++;
+			j++;
+		}
+		else if(n>m)
+		{
+			s.script->push_back('-');
+			i++;
+		}
+		else
+		{
+			s.script->push_back('+');
+			j++;
+		}
+	}
+	s.script->append(n-i,'-');
+	s.script->append(m-j,'+');
+}
+
+//the edit script of an LCS already found: its letters are matched from the left in both sequences
+void LCSscript(const char *s1, int l1, const char *s2, int l2, const char *lcs, int len, std::string &script)
+{
+	int i=0,j=0,k;
+	for(k = 0; k < len; k++)
+	{
+		for(; s1[i] != lcs[k]; i++)
+			script.push_back('-');
+		for(; s2[j] != lcs[k]; j++)
+			script.push_back('+');
+		script.push_back('=');
+		i++;
+		j++;
+	}
+	script.append(l1-i,'-');
+	script.append(l2-j,'+');
+}
+
+//script of a[0..n) and b[0..m) with D edits in O((n+m)D), or false after more than limit steps
+template<class T>
+static bool myerssearch(const T *a, int n, const T *b, int m, long long limit, std::string &script)
+{
+	myersstate s;
+	bool done;
+	s.off=(n+m+1)/2+1;
+	s.vf.resize(2*s.off+1);
+	s.vb.resize(2*s.off+1);
+	s.script=&script;
+	myers(s,a,n,b,m,limit,done);
+	return done;
+}
+
+//the top level search gives up after 1/MYERSWORK of the word steps of the bit-parallel table
+//(max*ceil(min/64)), about where Myers, whose time grows with D*D on random edits, stops being the
+//faster one; the LCS then comes from Hirschberg, or from the packed table for short sequences
+int LCSmyers(const char *s1, int l1, const char *s2, int l2, std::string &out, std::string &script)
+{
+	size_t start=out.size(),sstart=script.size(),k;
+	int lo=std::min(l1,l2),hi=std::max(l1,l2),len,i=0;
+	long long limit=(long long)hi*((lo+63)/64)/MYERSWORK+hi;
+	if(myerssearch(s1,l1,s2,l2,limit,script))
+	{
+		for(k = sstart; k < script.size(); k++)     //the letters of the LCS are the '=' steps of s1
+		{
+			if(script[k]=='=')
+				out.push_back(s1[i]);
+			if(script[k]!='+')
+				i++;
+		}
+		return out.size()-start;
+	}
+	script.resize(sstart);
+	len=lo<64?LCSpacked(s1,l1,s2,l2,out):LCShirschberg(s1,l1,s2,l2,out);
+	LCSscript(s1,l1,s2,l2,out.data()+start,len,script);
+	return len;
+}
+
+//the same search on line tokens, for the diff; the script is appended unless the search gives up
+bool LCSmyers(const int *a, int n, const int *b, int m, long long limit, std::string &script)
+{
+	size_t start=script.size();
+	if(myerssearch(a,n,b,m,limit,script))
+		return true;
+	script.resize(start);
+	return false;
+}
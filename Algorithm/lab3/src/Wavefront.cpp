@@ -0,0 +1,43 @@
+#include <vector>
+#include <algorithm>
+#include "Bitlcs.h"
+
+//tiled wavefront for the bit-parallel recurrence. the table is cut into tiles of C text symbols by
+//B pattern words; tile (i,j) runs the symbols of chunk i over block j of V. it needs block j as left
+//by tile (i-1,j) and, for every symbol, the carry out of block j-1 from tile (i,j-1), so tiles on
+//one anti-diagonal are independent. a tile touches only its V block, its masks (contiguous, see
+//bitpattern), its text chunk and one carry byte per symbol, all of which stay in cache.
+//tiles are OpenMP tasks ordered by depend on their block and chunk, no barrier between diagonals
+static void tile(const char *a, int la, bool reverse, bitpattern &p, bitstepfunc step, uint64_t *V,
+	unsigned char *carry, int i, int j, int C)
+{
+	int t,end=std::min(la,(i+1)*C);
+	uint64_t *vb=V+(size_t)j*p.B;
+	const uint64_t *mb=&p.masks[(size_t)j*p.nsym*p.B];
+	for(t = i*C; t < end; t++)
+	{
+		int s=p.slot[(unsigned char)(reverse?a[la-1-t]:a[t])];
+		if(s!=0)                            //symbols outside the pattern produce no carry anywhere
+			carry[t]=step(vb,mb+(size_t)s*p.B,p.B,carry[t]);
+	}
+}
+
+void wavefrontrun(const char *a, int la, bool reverse, bitpattern &p, int C, bool usesimd, std::vector<uint64_t> &V)
+{
+	int nb=p.W/p.B,nc=(la+C-1)/C,i,j;
+	std::vector<unsigned char> carry(la,0);  //carry into the next block, per text symbol; block 0 gets 0
+	std::vector<char> blockdep(nb),chunkdep(nc);
+	char *bd=&blockdep[0],*cd=&chunkdep[0];
+	(void)bd;                               //only named in depend clauses, which do not count as a use
+	(void)cd;
+	bitstepfunc step=pickstep(usesimd,p.B);
+	V.assign(p.W,~(uint64_t)0);
+	#pragma omp parallel
+	#pragma omp single
+	for(i = 0; i < nc; i++)
+		for(j = 0; j < nb; j++)
+		{
+			#pragma omp task firstprivate(i,j) shared(p,V,carry) depend(inout:bd[j],cd[i])
+			tile(a,la,reverse,p,step,&V[0],&carry[0],i,j,C);
+		}
+}
@@ -0,0 +1,148 @@
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "LCS.h"
+
+//LCS benchmark: inputs x sizes x engines, each measurement in a child process so that every engine
+//reports its own peak memory. one JSON object per line: seconds, DP cells per second, peak RSS (KB), length.
+//usage: ./bench [largest length, default 100000] [text file]
+//hirschberg and wavefront use OMP_NUM_THREADS threads, the other engines one
+//with a text file two different windows of it are compared as the "text" input
+static const char *inputs[]={"dna","bytes","text","similar"};
+static const char *engines[]={"dp","packed","hirschberg","bit_scalar","bit","wavefront","myers"};
+
+//random sequences over 4 symbols and over all 256 byte values, two windows of the text file,
+//or a random DNA sequence against a copy with n/100 single letter edits
+static bool generate(int input, int n, const std::string &text, std::string &s1, std::string &s2)
+{
+	std::mt19937_64 gen(2334+n);
+	int i;
+	if(input==2)
+	{
+		if((int)text.size()<2*n)
+			return false;
+		s1=text.substr(0,n);
+		s2=text.substr(text.size()/2,n);
+		return true;
+	}
+	if(input==3)
+	{
+		s1.resize(n);
+		for(i = 0; i < n; i++)
+			s1[i]="ACGT"[gen()%4];
+		s2=s1;
+		for(i = 0; i < n/100; i++)
+		{
+			size_t k=gen()%s2.size();
+			int op=gen()%3;
+			if(op==0) s2.erase(k,1);
+			else if(op==1) s2.insert(k,1,"ACGT"[gen()%4]);
+			else s2[k]="ACGT"[gen()%4];
+		}
+		return true;
+	}
+	s1.resize(n);
+	s2.resize(n);
+	for(i = 0; i < n; i++)
+	{
+		s1[i]=input==0?"ACGT"[gen()%4]:(char)(gen()%256);
+		s2[i]=input==0?"ACGT"[gen()%4]:(char)(gen()%256);
+	}
+	return true;
+}
+
+//the classic tables take 8 bytes per cell and the packed table 2 bits per cell;
+//myers falls back to hirschberg unless the sequences are close
+static bool feasible(int eng, int input, long long n)
+{
+	if(eng==0) return n<=4000;
+	if(eng==1) return n<=30000;
+	if(eng==2) return n<=100000;
+	if(eng==6) return input==3 || n<=100000;
+	return true;
+}
+
+static int run(int eng, const std::string &s1, const std::string &s2)
+{
+	std::string out,script;
+	int l1=s1.size(),l2=s2.size();
+	switch(eng)
+	{
+		case 0:
+			return LCSsolve(enginedp,s1,s2,out,NULL);
+		case 1:
+			return LCSpacked(s1.data(),l1,s2.data(),l2,out);
+		case 2:
+			return LCShirschberg(s1.data(),l1,s2.data(),l2,out);
+		case 3:
+			return LCSbitlength(s1.data(),l1,s2.data(),l2,false,false);
+		case 4:
+			return LCSbitlength(s1.data(),l1,s2.data(),l2,true,false);
+		case 5:
+			return LCSbitlength(s1.data(),l1,s2.data(),l2,true,true);
+		default:
+			return LCSmyers(s1.data(),l1,s2.data(),l2,out,script);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	long long maxn=(argc>1)?atoll(argv[1]):100000,n;
+	int input,eng;
+	std::string text;
+	if(argc>2)
+	{
+		FILE *in=fopen(argv[2],"rb");
+		char buf[1<<16];
+		size_t k;
+		if(in==NULL)
+		{
+			printf("Can't read %s!\n",argv[2]);
+			return 1;
+		}
+		while((k=fread(buf,1,sizeof(buf),in))>0)
+			text.append(buf,k);
+		fclose(in);
+	}
+	for(input = 0; input < 4; input++)
+		for(n = 1000; n <= maxn; n *= 10)
+			for(eng = 0; eng < 7; eng++)
+			{
+				std::string s1,s2;
+				if(!feasible(eng,input,n) || !generate(input,n,text,s1,s2)) continue;
+				int fd[2];
+				if(pipe(fd)<0) return 1;
+				fflush(stdout);
+				pid_t pid=fork();
+				if(pid==0)                      //child: time one engine, send the result back through the pipe
+				{
+					close(fd[0]);
+					std::chrono::steady_clock::time_point t0=std::chrono::steady_clock::now();
+					int len=run(eng,s1,s2);
+					double res[2]={std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count(),(double)len};
+					if(write(fd[1],res,sizeof(res))!=sizeof(res)) _exit(1);
+					_exit(0);
+				}
+				close(fd[1]);
+				double res[2];
+				struct rusage ru;
+				bool ok=read(fd[0],res,sizeof(res))==sizeof(res);
+				close(fd[0]);
+				int status;
+				wait4(pid,&status,0,&ru);
+				if(!ok || !WIFEXITED(status) || WEXITSTATUS(status)!=0)
+				{
+					printf("{\"input\":\"%s\",\"n\":%lld,\"engine\":\"%s\",\"error\":true}\n",inputs[input],n,engines[eng]);
+					continue;
+				}
+				printf("{\"input\":\"%s\",\"n\":%lld,\"engine\":\"%s\",\"seconds\":%.6f,\"cells_per_sec\":%.4g,"
+					"\"peak_rss_kb\":%ld,\"length\":%d}\n",inputs[input],n,engines[eng],res[0],
+					res[0]>0?(double)n*n/res[0]:0,ru.ru_maxrss,(int)res[1]);
+			}
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <stdio.h>
+#include <stdlib.h>
+#include "LCS.h"
+
+//read a whole file as one sequence; a trailing line break is not part of it
+static bool readseq(const char *file, std::string &s)
+{
+	FILE *in=fopen(file,"rb");
+	char buf[1<<16];
+	size_t n;
+	if(in==NULL)
+		return false;
+	s.clear();
+	while((n=fread(buf,1,sizeof(buf),in))>0)
+		s.append(buf,n);
+	fclose(in);
+	while(!s.empty() && (s[s.size()-1]=='\n' || s[s.size()-1]=='\r'))
+		s.erase(s.size()-1);
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	std::string s1,s2,lcs,script;
+	const char *files[2];
+	int i,nfile=0,len,engine=engineauto,context=3;
+	bool diff=false,showscript=false;
+
+	//-e dp/packed/hirschberg/bit/myers picks the engine, two file names read the sequences from files,
+	//-s prints the edit script as well, -d compares the two files line by line and prints a unified
+	//diff with -U lines of context
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i],"-d")==0)
+			diff=true;
+		else if(strcmp(argv[i],"-s")==0)
+			showscript=true;
+		else if(strcmp(argv[i],"-U")==0 && i+1<argc)
+			context=atoi(argv[++i]);
+		else if(strcmp(argv[i],"-e")==0 && i+1<argc)
+		{
+			i++;
+			if(strcmp(argv[i],"dp")==0) engine=enginedp;
+			else if(strcmp(argv[i],"packed")==0) engine=enginepacked;
+			else if(strcmp(argv[i],"hirschberg")==0) engine=enginehirschberg;
+			else if(strcmp(argv[i],"bit")==0) engine=enginebit;
+			else if(strcmp(argv[i],"myers")==0) engine=enginemyers;
+			else engine=engineauto;
+		}
+		else if(nfile<2)
+			files[nfile++]=argv[i];
+	}
+
+	if(diff)
+	{
+		if(nfile<2)
+		{
+			printf("Usage: ./main -d [-U lines] file1 file2\n");
+			return 2;
+		}
+		return LCSdiff(files[0],files[1],context<0?0:context);
+	}
+
+    //get input
+	if(nfile==2)
+	{
+		if(!readseq(files[0],s1) || !readseq(files[1],s2))
+		{
+			printf("Can't read the sequence files!\n");
+			return 1;
+		}
+	}
+	else
+	{
+		printf("Input the first string:\n");
+		std::cin>>s1;
+		printf("Input the second string:\n");
+		std::cin>>s2;
+	}
+
+    //get LCS result
+	len=LCSsolve(engine,s1,s2,lcs,showscript?&script:NULL);
+	printf("The LCS length is:%d\n",len);
+	if(engine==enginebit)                   //the bit-parallel engine gives the length only
+		return 0;
+	printf("The LCS is:");
+	fwrite(lcs.data(),1,lcs.size(),stdout);
+	printf("\n");
+	if(!showscript)
+		return 0;
+	printf("The edit script is:");           //runs of one operation, e.g. 12=1-3+ keeps 12, deletes 1, inserts 3
+	for(size_t k = 0, r; k < script.size(); k += r)
+	{
+		for(r = 1; k+r < script.size() && script[k+r]==script[k]; r++);
+		printf("%zu%c",r,script[k]);
+	}
+	printf("\n");
+	return 0;
+}